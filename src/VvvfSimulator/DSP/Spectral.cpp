@@ -0,0 +1,165 @@
+#include "Spectral.hpp"
+
+// Standard Library
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+// Internal
+#include "../Vvvf/InternalMath.hpp"
+
+namespace VvvfSimulator::DSP::Spectral
+{
+	namespace
+	{
+		std::vector<double> makeWindow(std::size_t size, WindowType windowType)
+		{
+			using NAMESPACE_VVVF::InternalMath::m_2PI;
+
+			std::vector<double> window(size, 1.0);
+			if (size < 2 || windowType == WindowType::Rectangular) return window;
+
+			const double step = m_2PI / static_cast<double>(size - 1);
+			for (std::size_t n = 0; n < size; n++)
+			{
+				const double x = step * static_cast<double>(n);
+				switch (windowType)
+				{
+				case WindowType::Hann:     window[n] = 0.5 - 0.5 * std::cos(x); break;
+				case WindowType::Hamming:  window[n] = 0.54 - 0.46 * std::cos(x); break;
+				case WindowType::Blackman: window[n] = 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x); break;
+				default: break;
+				}
+			}
+			return window;
+		}
+	}
+
+	Plan::Plan(std::size_t size, WindowType windowType)
+		: m_size(size)
+		, m_windowType(windowType)
+		, m_window(makeWindow(size, windowType))
+		, m_fft(size % 2 == 0 ? size / 2 : size, false)
+	{
+		if (size == 0) throw std::invalid_argument("Spectral::Plan: size must be positive");
+	}
+
+	void Plan::applyWindow(std::span<double> samples) const
+	{
+		const std::size_t count = std::min(samples.size(), m_size);
+		for (std::size_t i = 0; i < count; i++) samples[i] *= m_window[i];
+	}
+
+	void Plan::transform(std::span<const double> input, std::span<Complex> out) const
+	{
+		if (input.size() < m_size || out.size() < binCount())
+			throw std::invalid_argument("Spectral::Plan::transform: buffer too small");
+
+		if (m_size % 2 == 0)
+		{
+			// transform_real() packs the (real) Nyquist bin into bin 0's imaginary part
+			m_fft.transform_real(input.data(), out.data());
+			const double nyquist = out[0].imag();
+			out[0] = Complex(out[0].real(), 0.0);
+			out[m_size / 2] = Complex(nyquist, 0.0);
+			return;
+		}
+
+		thread_local std::vector<Complex> complexInput, complexOutput;
+		complexInput.assign(input.begin(), input.begin() + m_size);
+		complexOutput.resize(m_size);
+		m_fft.transform(complexInput.data(), complexOutput.data());
+		std::copy_n(complexOutput.cbegin(), binCount(), out.begin());
+	}
+
+	void Plan::windowAndTransform(std::span<double> samples, std::span<Complex> out) const
+	{
+		applyWindow(samples);
+		transform(samples, out);
+	}
+
+	std::shared_ptr<const Plan> getPlan(std::size_t size, WindowType windowType)
+	{
+		struct Entry
+		{
+			std::size_t size;
+			WindowType windowType;
+			std::shared_ptr<const Plan> plan;
+			std::uint64_t lastUse;
+		};
+
+		static std::mutex mutex;
+		static std::vector<Entry> plans;
+		static std::uint64_t useCount = 0;
+
+		std::lock_guard lock(mutex);
+		useCount++;
+		const auto cached = std::find_if(plans.begin(), plans.end(), [&](const Entry &entry)
+		{
+			return entry.size == size && entry.windowType == windowType;
+		});
+		if (cached != plans.end())
+		{
+			cached->lastUse = useCount;
+			return cached->plan;
+		}
+
+		// Drop the least recently used plan; whoever still holds it keeps it alive
+		if (plans.size() >= MaxCachedPlans)
+			plans.erase(std::min_element(plans.begin(), plans.end(), [](const Entry &a, const Entry &b)
+			{
+				return a.lastUse < b.lastUse;
+			}));
+		plans.push_back({ size, windowType, std::make_shared<const Plan>(size, windowType), useCount });
+		return plans.back().plan;
+	}
+
+	Analyzer::Analyzer(std::size_t size, WindowType windowType)
+		: m_plan(getPlan(size, windowType))
+		, m_history(size, 0.0)
+		, m_scratch(size)
+		, m_bins(m_plan->binCount())
+	{
+		const auto &window = m_plan->window();
+		const double gain = std::accumulate(window.cbegin(), window.cend(), 0.0);
+		m_scale = gain > 0.0 ? 2.0 / gain : 0.0;
+	}
+
+	void Analyzer::push(std::span<const float> samples)
+	{
+		for (const float sample : samples)
+		{
+			m_history[m_head] = sample;
+			m_head = (m_head + 1) % m_history.size();
+		}
+	}
+
+	void Analyzer::push(std::span<const double> samples)
+	{
+		for (const double sample : samples)
+		{
+			m_history[m_head] = sample;
+			m_head = (m_head + 1) % m_history.size();
+		}
+	}
+
+	void Analyzer::clear()
+	{
+		std::fill(m_history.begin(), m_history.end(), 0.0);
+		m_head = 0;
+	}
+
+	void Analyzer::analyze(std::vector<double> &magnitudes)
+	{
+		// Oldest sample first
+		const auto head = m_history.cbegin() + static_cast<std::ptrdiff_t>(m_head);
+		std::copy(m_history.cbegin(), head, std::copy(head, m_history.cend(), m_scratch.begin()));
+		m_plan->windowAndTransform(m_scratch, m_bins);
+
+		magnitudes.resize(m_bins.size());
+		for (std::size_t k = 0; k < m_bins.size(); k++) magnitudes[k] = std::abs(m_bins[k]) * m_scale;
+	}
+}
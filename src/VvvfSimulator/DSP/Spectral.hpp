@@ -0,0 +1,97 @@
+#pragma once
+
+// Standard Library
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+// Packages
+#include <kissfft/kissfft.hh>
+
+namespace VvvfSimulator::DSP::Spectral
+{
+	enum class WindowType
+	{
+		Rectangular, Hann, Hamming, Blackman
+	};
+
+	/*
+	@brief Window coefficients and FFT plan for one (size, window type) pair.
+	Immutable once built, so a single instance from getPlan() is shared by
+	every thread: kissfft's transforms are const.
+
+	Even sizes go through kissfft::transform_real() on a half-size complex
+	plan, which does half the work of a complex transform with a zero
+	imaginary part; odd sizes fall back to the latter.
+	*/
+	class Plan
+	{
+		std::size_t m_size;
+		WindowType m_windowType;
+		std::vector<double> m_window;
+		kissfft<double> m_fft;
+
+	public:
+		using Complex = std::complex<double>;
+
+		Plan(std::size_t size, WindowType windowType);
+
+		constexpr std::size_t size() const noexcept { return m_size; }
+		constexpr WindowType windowType() const noexcept { return m_windowType; }
+		/// Number of output bins of transform(): size() / 2 + 1
+		constexpr std::size_t binCount() const noexcept { return m_size / 2 + 1; }
+		const std::vector<double> &window() const noexcept { return m_window; }
+
+		void applyWindow(std::span<double> samples) const;
+
+		/*
+		@brief Real-to-complex DFT of input (size() samples, not windowed here)
+		into out (binCount() bins, DC to Nyquist). The remaining bins are the
+		complex conjugates of these.
+		*/
+		void transform(std::span<const double> input, std::span<Complex> out) const;
+
+		/// applyWindow() in place, then transform()
+		void windowAndTransform(std::span<double> samples, std::span<Complex> out) const;
+	};
+
+	/// Plans getPlan() keeps around, least recently used dropped first
+	inline constexpr std::size_t MaxCachedPlans = 16;
+
+	/*
+	@brief Shared plan for (size, windowType), built on first use. The last
+	MaxCachedPlans plans used stay cached.
+	*/
+	std::shared_ptr<const Plan> getPlan(std::size_t size, WindowType windowType = WindowType::Rectangular);
+
+	/*
+	@brief Magnitude spectrum of a sample stream, e.g. the blocks the
+	real-time generator produces: keeps the last size() samples and its own
+	scratch buffers, so analyze() does not allocate. Not thread-safe; use one
+	per thread.
+	*/
+	class Analyzer
+	{
+		std::shared_ptr<const Plan> m_plan;
+		std::vector<double> m_history, m_scratch;
+		std::vector<Plan::Complex> m_bins;
+		std::size_t m_head = 0;
+		double m_scale;
+
+	public:
+		Analyzer(std::size_t size, WindowType windowType = WindowType::Hann);
+
+		std::size_t size() const noexcept { return m_plan->size(); }
+		void push(std::span<const float> samples);
+		void push(std::span<const double> samples);
+		void clear();
+
+		/*
+		@brief Amplitude of each bin of the windowed history, normalized by
+		the window's coherent gain so that a full-scale sine reads about 1.
+		magnitudes is resized to Plan::binCount().
+		*/
+		void analyze(std::vector<double> &magnitudes);
+	};
+}
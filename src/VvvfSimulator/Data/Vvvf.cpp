@@ -3,7 +3,12 @@
 
 // Standard Library
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
 #include <sstream>
+// Packages
+#include <QDebug>
 
 namespace VvvfSimulator::Data
 {
@@ -56,32 +61,12 @@ namespace VvvfSimulator::Data
     // ===== Analysis Methods (ex-Analyze) =====
 
     namespace {
-        /// Helper to find control data in sorted pattern list
-        template <typename TPattern>
-        std::optional<TPattern>
-        findCurrentPattern(const std::vector<TPattern> &patterns,
-                                double controlFrequency)
+        void fillControlFrequencyData(const Vvvf::PulseControl& pattern, Vvvf::ControlFrequencyData& data)
         {
-            if (patterns.empty())
-                return std::nullopt;
+            using PulseControl = Vvvf::PulseControl;
+            using PulseMode = Vvvf::PulseMode;
+            using WaveForm = Vvvf::WaveForm;
 
-            for (auto it = patterns.rbegin(); it != patterns.rend(); ++it)
-            {
-                if (controlFrequency >= it->controlFrequencyFrom)
-                    return *it;
-            }
-            return patterns.front();
-        }
-    }
-
-    Vvvf::ControlFrequencyData
-    Vvvf::getControlFrequencyData(double controlFrequency) const
-    {
-        ControlFrequencyData data;
-        auto accelPattern = getCurrentAcceleratePattern(controlFrequency);
-        auto brakePattern = getCurrentBrakingPattern(controlFrequency);
-
-        auto fillData = [&](const PulseControl& pattern) {
             // Map baseWave to waveForm
             data.waveForm = static_cast<WaveForm>(pattern.pulseMode.baseWave);
             
@@ -126,12 +111,37 @@ namespace VvvfSimulator::Data
                     data.pulseMode = PulseMode::PWM;
                     break;
             }
-        };
+        }
+
+        /// Helper to find control data in sorted pattern list
+        template <typename TPattern>
+        std::optional<TPattern>
+        findCurrentPattern(const std::vector<TPattern> &patterns,
+                                double controlFrequency)
+        {
+            if (patterns.empty())
+                return std::nullopt;
+
+            for (auto it = patterns.rbegin(); it != patterns.rend(); ++it)
+            {
+                if (controlFrequency >= it->controlFrequencyFrom)
+                    return *it;
+            }
+            return patterns.front();
+        }
+    }
+
+    Vvvf::ControlFrequencyData
+    Vvvf::getControlFrequencyData(double controlFrequency) const
+    {
+        ControlFrequencyData data;
+        auto accelPattern = getCurrentAcceleratePattern(controlFrequency);
+        auto brakePattern = getCurrentBrakingPattern(controlFrequency);
 
         if (accelPattern) {
-            fillData(*accelPattern);
+            fillControlFrequencyData(*accelPattern, data);
         } else if (brakePattern) {
-            fillData(*brakePattern);
+            fillControlFrequencyData(*brakePattern, data);
         } else {
             data.waveForm = WaveForm::Sine;
             data.amplitude = 0.0;
@@ -222,6 +232,470 @@ namespace VvvfSimulator::Data
         return getControlFrequencyData(controlFrequency).bipolar;
     }
 
+    Vvvf::Compiled Vvvf::getCompiled() const
+    {
+        return Compiled(*this);
+    }
+
+    // ===== Compiled =====
+
+    Vvvf::Compiled::Function::Function(const PulseControl::FunctionValue& source)
+        : type(source.type)
+        , start(source.start)
+        , end(source.end)
+        , startValue(source.startValue)
+        , endValue(source.endValue)
+        , degree(source.degree)
+    {
+        using FT = PulseControl::FunctionValue::FunctionType;
+        switch (type)
+        {
+        case FT::Proportional:
+            slope = (endValue - startValue) / (end - start);
+            break;
+        case FT::Inv_Proportional:
+        {
+            origin = 1.0 / startValue;
+            slope = (1.0 / endValue - origin) / (end - start);
+
+            c = -source.curveRate;
+            const double& k = endValue;
+            const double& l = startValue;
+            a = 1 / ((1 / l) - (1 / k)) * (1 / (l - c) - 1 / (k - c));
+            b = 1 / (1 - (1 / l) * k) * (1 / (l - c) - (1 / l) * k / (k - c));
+            break;
+        }
+        case FT::Sine:
+            origin = std::asin(startValue / endValue);
+            slope = (std::numbers::pi / 2.0 - origin) / (end - start);
+            break;
+        default: // case FT::Pow2_Exponential:
+            break;
+        }
+    }
+
+    double Vvvf::Compiled::Function::operator()(double x) const noexcept
+    {
+        using FT = PulseControl::FunctionValue::FunctionType;
+        switch (type)
+        {
+        case FT::Proportional:
+            return startValue + slope * (x - start);
+        case FT::Pow2_Exponential:
+            return std::pow(2.0, std::pow((x - start) / (end - start), degree) - 1.0) * (endValue - startValue) + startValue;
+        case FT::Inv_Proportional:
+            return 1 / (a * (origin + slope * (x - start)) + b) + c;
+        case FT::Sine:
+            return std::sin(slope * (x - start) + origin) * endValue;
+        default:
+            return 1000.0;
+        }
+    }
+
+    double Vvvf::Compiled::Curve::operator()(double controlFrequency) const noexcept
+    {
+        switch (kind)
+        {
+        case Kind::Function:
+            return function(controlFrequency);
+        case Kind::Table:
+        {
+            if (table.empty())
+                return constant;
+            // Last entry at or below the frequency; the first one below the table
+            auto it = std::upper_bound(table.begin(), table.end(), controlFrequency,
+                [](double f, const std::pair<double, double>& entry) { return f < entry.first; });
+            if (it == table.begin())
+                return it->second;
+            const auto& [fromFrequency, fromValue] = *(it - 1);
+            if (!interpolate || it == table.end() || it->first == fromFrequency)
+                return fromValue;
+            return fromValue + (it->second - fromValue) / (it->first - fromFrequency) * (controlFrequency - fromFrequency);
+        }
+        default: // case Kind::Constant:
+            return constant;
+        }
+    }
+
+    namespace {
+        template <typename TEntry>
+        std::vector<std::pair<double, double>> sortedTable(const std::vector<TEntry>& entries, double TEntry::* key, double TEntry::* value)
+        {
+            std::vector<std::pair<double, double>> table;
+            table.reserve(entries.size());
+            for (const auto& entry : entries)
+                table.emplace_back(entry.*key, entry.*value);
+            std::stable_sort(table.begin(), table.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+            return table;
+        }
+
+        Vvvf::Compiled::Curve amplitudeCurve(const Vvvf::PulseControl::AmplitudeValue& amplitude)
+        {
+            using Curve = Vvvf::Compiled::Curve;
+            using Mode = Vvvf::PulseControl::AmplitudeValue::AmplitudeMode;
+            using Entry = Vvvf::PulseControl::AmplitudeValue::AmplitudeTableEntry;
+
+            Curve curve;
+            curve.constant = amplitude.constant;
+            switch (amplitude.mode)
+            {
+            case Mode::Moving:
+                curve.kind = Curve::Kind::Function;
+                curve.function = Vvvf::Compiled::Function(amplitude.movingValue);
+                break;
+            case Mode::Table:
+                curve.kind = Curve::Kind::Table;
+                curve.table = sortedTable(amplitude.table, &Entry::frequency, &Entry::amplitude);
+                curve.interpolate = amplitude.tableInterpolation;
+                break;
+            default:
+                break;
+            }
+            return curve;
+        }
+
+        Vvvf::Compiled::Curve carrierCurve(const Vvvf::PulseControl::AsyncControl::CarrierFrequency& carrier)
+        {
+            using Curve = Vvvf::Compiled::Curve;
+            using Mode = Vvvf::PulseControl::AsyncControl::CarrierFrequency::CarrierFrequencyMode;
+            using Entry = Vvvf::PulseControl::AsyncControl::CarrierFrequency::CarrierTableEntry;
+
+            Curve curve;
+            curve.constant = carrier.constant;
+            switch (carrier.mode)
+            {
+            case Mode::Moving:
+                curve.kind = Curve::Kind::Function;
+                curve.function = Vvvf::Compiled::Function(carrier.movingValue);
+                break;
+            case Mode::Table:
+                curve.kind = Curve::Kind::Table;
+                curve.table = sortedTable(carrier.table, &Entry::controlFrequency, &Entry::carrierFrequency);
+                curve.interpolate = carrier.tableInterpolation;
+                break;
+            default:
+                break;
+            }
+            return curve;
+        }
+
+        // ===== Region rules =====
+
+        using Mascon = Vvvf::Compiled::State::Mascon;
+
+        bool isEnabled(const Vvvf::PulseControl& pattern, Mascon mascon) noexcept
+        {
+            switch (mascon)
+            {
+            case Mascon::FreeRunOn:
+                return pattern.enableFreeRunOn;
+            case Mascon::FreeRunOff:
+                return pattern.enableFreeRunOff;
+            default:
+                return pattern.enableNormal;
+            }
+        }
+
+        /// A stuck pattern is matched on the rotation frequency instead of the
+        /// control frequency while free running, so it stays selected while the
+        /// control frequency ramps away from the rotation frequency
+        bool isStuck(const Vvvf::PulseControl& pattern, Mascon mascon) noexcept
+        {
+            switch (mascon)
+            {
+            case Mascon::FreeRunOn:
+                return pattern.stuckFreeRunOn;
+            case Mascon::FreeRunOff:
+                return pattern.stuckFreeRunOff;
+            default:
+                return false;
+            }
+        }
+
+        bool hasRotationBounds(const Vvvf::PulseControl& pattern) noexcept
+        {
+            return pattern.rotateFrequencyFrom >= 0.0 || pattern.rotateFrequencyBelow >= 0.0;
+        }
+
+        bool isWithinRotation(const Vvvf::PulseControl& pattern, double sineFrequency) noexcept
+        {
+            return (pattern.rotateFrequencyFrom < 0.0 || sineFrequency >= pattern.rotateFrequencyFrom) &&
+                   (pattern.rotateFrequencyBelow < 0.0 || sineFrequency < pattern.rotateFrequencyBelow);
+        }
+    }
+
+    Vvvf::Compiled::Table::Table(const std::vector<PulseControl>& patterns)
+    {
+        regions.reserve(patterns.size());
+        for (const auto& pattern : patterns)
+        {
+            using PT = PulseControl::Pulse::PulseTypeName;
+            Region& region = regions.emplace_back();
+            region.pattern = pattern;
+            fillControlFrequencyData(pattern, region.data);
+            region.isAsync = pattern.pulseMode.pulseType == PT::ASYNC;
+            region.requiresCustomPwm = region.data.pulseMode == PulseMode::CHM ||
+                                       region.data.pulseMode == PulseMode::SHE;
+            region.amplitude = amplitudeCurve(pattern.amplitude);
+            region.carrierFrequency = carrierCurve(pattern.asyncModulationData.carrierWaveData);
+        }
+
+        for (const auto& pattern : patterns)
+            breakpoints.push_back(pattern.controlFrequencyFrom);
+        std::sort(breakpoints.begin(), breakpoints.end());
+        breakpoints.erase(std::unique(breakpoints.begin(), breakpoints.end()), breakpoints.end());
+
+        // Resolve each interval once with the same reverse scan as
+        // findCurrentPattern(), so the answer doesn't depend on the list order.
+        regionIndex.reserve(breakpoints.size());
+        for (const double from : breakpoints)
+        {
+            uint32_t index = 0;
+            for (size_t i = patterns.size(); i-- > 0;)
+            {
+                if (from >= patterns[i].controlFrequencyFrom)
+                {
+                    index = static_cast<uint32_t>(i);
+                    break;
+                }
+            }
+            regionIndex.push_back(index);
+        }
+
+        // Same again per mascon state, over the patterns enabled in it
+        for (size_t m = 0; m < lookups.size(); m++)
+        {
+            const auto mascon = static_cast<Mascon>(m);
+            Lookup& lookup = lookups[m];
+
+            std::vector<uint32_t> enabled;
+            for (size_t i = 0; i < patterns.size(); i++)
+            {
+                if (!isEnabled(patterns[i], mascon))
+                    continue;
+                enabled.push_back(static_cast<uint32_t>(i));
+                if (hasRotationBounds(patterns[i]) || isStuck(patterns[i], mascon))
+                    lookup.byControlFrequency = false;
+            }
+            if (enabled.empty())
+                continue;
+
+            lookup.first = enabled.front();
+            for (const uint32_t i : enabled)
+                lookup.breakpoints.push_back(patterns[i].controlFrequencyFrom);
+            std::sort(lookup.breakpoints.begin(), lookup.breakpoints.end());
+            lookup.breakpoints.erase(std::unique(lookup.breakpoints.begin(), lookup.breakpoints.end()), lookup.breakpoints.end());
+
+            lookup.regionIndex.reserve(lookup.breakpoints.size());
+            for (const double from : lookup.breakpoints)
+            {
+                const auto it = std::find_if(enabled.rbegin(), enabled.rend(),
+                    [&](uint32_t i) { return from >= patterns[i].controlFrequencyFrom; });
+                lookup.regionIndex.push_back(*it);
+            }
+        }
+    }
+
+    const Vvvf::Compiled::Region*
+    Vvvf::Compiled::Table::find(double controlFrequency) const noexcept
+    {
+        if (regions.empty())
+            return nullptr;
+
+        const auto it = std::upper_bound(breakpoints.begin(), breakpoints.end(), controlFrequency);
+        // Below the lowest breakpoint the first pattern applies, as in findCurrentPattern()
+        if (it == breakpoints.begin())
+            return &regions.front();
+        return &regions[regionIndex[static_cast<size_t>(it - breakpoints.begin()) - 1]];
+    }
+
+    const Vvvf::Compiled::Region*
+    Vvvf::Compiled::Table::find(const State& state, double& lower, double& upper) const noexcept
+    {
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+        const Lookup& lookup = lookups[static_cast<size_t>(state.mascon())];
+        if (!lookup.byControlFrequency)
+        {
+            lower = upper = state.controlFrequency;
+            return match(state);
+        }
+        if (!lookup.first)
+        {
+            lower = -infinity;
+            upper = infinity;
+            return nullptr;
+        }
+
+        const auto it = std::upper_bound(lookup.breakpoints.begin(), lookup.breakpoints.end(), state.controlFrequency);
+        lower = it == lookup.breakpoints.begin() ? -infinity : *(it - 1);
+        upper = it == lookup.breakpoints.end() ? infinity : *it;
+        if (it == lookup.breakpoints.begin())
+            return &regions[*lookup.first];
+        return &regions[lookup.regionIndex[static_cast<size_t>(it - lookup.breakpoints.begin()) - 1]];
+    }
+
+    const Vvvf::Compiled::Region*
+    Vvvf::Compiled::Table::match(const State& state) const noexcept
+    {
+        const Mascon mascon = state.mascon();
+        const Region* fallback = nullptr;
+        const Region* found = nullptr;
+        for (const Region& region : regions)
+        {
+            const PulseControl& pattern = region.pattern;
+            if (!isEnabled(pattern, mascon) || !isWithinRotation(pattern, state.sineFrequency))
+                continue;
+            if (!fallback)
+                fallback = &region;
+            const double frequency = isStuck(pattern, mascon) ? state.sineFrequency : state.controlFrequency;
+            if (frequency >= pattern.controlFrequencyFrom)
+                found = &region;
+        }
+        return found ? found : fallback;
+    }
+
+    Vvvf::Compiled::Compiled(const Vvvf& source)
+        : level(source.level)
+        , accelerate(source.acceleratePattern)
+        , braking(source.brakingPattern)
+    {
+        m_fallback.waveForm = WaveForm::Sine;
+        m_fallback.amplitude = 0.0;
+        m_fallback.carrierFrequency = 0.0;
+        m_fallback.bipolar = 3;
+        m_fallback.pulseMode = PulseMode::PWM;
+    }
+
+    const Vvvf::Compiled::Region*
+    Vvvf::Compiled::findDataRegion(double controlFrequency) const noexcept
+    {
+        if (!accelerate.empty())
+            return accelerate.find(controlFrequency);
+        return braking.find(controlFrequency);
+    }
+
+    const Vvvf::ControlFrequencyData&
+    Vvvf::Compiled::getControlFrequencyData(double controlFrequency) const noexcept
+    {
+        const Region* region = findDataRegion(controlFrequency);
+        return region ? region->data : m_fallback;
+    }
+
+    const Vvvf::PulseControl*
+    Vvvf::Compiled::getCurrentAcceleratePattern(double controlFrequency) const noexcept
+    {
+        const Region* region = accelerate.find(controlFrequency);
+        return region ? &region->pattern : nullptr;
+    }
+
+    const Vvvf::PulseControl*
+    Vvvf::Compiled::getCurrentBrakingPattern(double controlFrequency) const noexcept
+    {
+        const Region* region = braking.find(controlFrequency);
+        return region ? &region->pattern : nullptr;
+    }
+
+    bool Vvvf::Compiled::requiresCustomPwm(double controlFrequency) const noexcept
+    {
+        const Region* region = findDataRegion(controlFrequency);
+        return region && region->requiresCustomPwm;
+    }
+
+    double Vvvf::Compiled::getAmplitude(double controlFrequency) const noexcept
+    {
+        return getControlFrequencyData(controlFrequency).amplitude;
+    }
+
+    Vvvf::PulseMode Vvvf::Compiled::getPulseMode(double controlFrequency) const noexcept
+    {
+        return getControlFrequencyData(controlFrequency).pulseMode;
+    }
+
+    double Vvvf::Compiled::getCarrierFrequency(double controlFrequency) const noexcept
+    {
+        return getControlFrequencyData(controlFrequency).carrierFrequency;
+    }
+
+    bool Vvvf::Compiled::isAsyncMode(double controlFrequency) const noexcept
+    {
+        const Region* accelRegion = accelerate.find(controlFrequency);
+        if (accelRegion && accelRegion->isAsync)
+            return true;
+        const Region* brakeRegion = braking.find(controlFrequency);
+        return brakeRegion && brakeRegion->isAsync;
+    }
+
+    int Vvvf::Compiled::getBipolar(double controlFrequency) const noexcept
+    {
+        return getControlFrequencyData(controlFrequency).bipolar;
+    }
+
+    const Vvvf::Compiled::Table& Vvvf::Compiled::selectTable(const State& state) const noexcept
+    {
+        if (state.brake)
+            return braking.empty() ? accelerate : braking;
+        return accelerate.empty() ? braking : accelerate;
+    }
+
+    Vvvf::Compiled::Resolved Vvvf::Compiled::resolve(const State& state) const noexcept
+    {
+        Resolved resolved;
+        resolved.region = selectTable(state).match(state);
+        if (resolved.region)
+        {
+            resolved.amplitude = resolved.region->amplitude(state.controlFrequency);
+            resolved.carrierFrequency = resolved.region->carrierFrequency(state.controlFrequency);
+        }
+        return resolved;
+    }
+
+    Vvvf::Compiled::Resolver::Resolver(const Compiled& compiled) noexcept
+        : m_compiled(&compiled)
+    {}
+
+    void Vvvf::Compiled::Resolver::invalidate() noexcept
+    {
+        m_lower = 0.0;
+        m_upper = -1.0;
+    }
+
+    const Vvvf::Compiled::Resolved& Vvvf::Compiled::Resolver::resolve(const State& state)
+    {
+        const double f = state.controlFrequency;
+        if (!(m_lower <= f && f < m_upper) || !state.sameFlags(m_state))
+        {
+            m_resolved.region = m_compiled->selectTable(state).find(state, m_lower, m_upper);
+            m_searchCount++;
+        }
+        m_state = state;
+
+        if (m_resolved.region)
+        {
+            m_resolved.amplitude = m_resolved.region->amplitude(f);
+            m_resolved.carrierFrequency = m_resolved.region->carrierFrequency(f);
+        }
+        else
+        {
+            m_resolved.amplitude = 0.0;
+            m_resolved.carrierFrequency = 0.0;
+        }
+
+        if (m_crossCheck)
+        {
+            const Resolved reference = m_compiled->resolve(state);
+            if (!(reference == m_resolved))
+            {
+                m_mismatchCount++;
+                qWarning().nospace() << "Vvvf::Compiled::Resolver: incremental result differs from the full resolution at "
+                                     << f << " Hz, rotation " << state.sineFrequency << " Hz (brake " << state.brake << ", mascon off " << state.masconOff
+                                     << ", free run " << state.freeRun << ")";
+                m_resolved = reference;
+            }
+        }
+        return m_resolved;
+    }
+
     // ===== Serialization Methods =====
 
     rfl::Result<rfl::Nothing> Vvvf::save(const std::filesystem::path& path, RflCppFormats format) const
@@ -20,11 +20,14 @@
 // Version 1.10.0.0
 
 // Standard Library
+#include <array>
 #include <cinttypes>
+#include <cstddef>
 #include <filesystem>
 #include <map>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 // Internal
 #include "Util.hpp"
@@ -40,6 +43,7 @@ namespace VvvfSimulator::Data
         enum class PulseMode : uint_fast8_t;
         enum class WaveForm : uint_fast8_t;
         struct ControlFrequencyData;
+        struct Compiled;
 
         /// Main VVVF sound/control data structure
         /// PWM level (2 or 3)
@@ -394,6 +398,10 @@ namespace VvvfSimulator::Data
 
         /// Calculate bipolar value at frequency
         int getBipolar(double controlFrequency) const;
+
+        /// Build the lookup table form of the patterns, for per-sample queries
+        Compiled getCompiled() const;
+
         /// Save to file with specified format
         rfl::Result<rfl::Nothing> save(const std::filesystem::path& path, RflCppFormats format = RflCppFormats::YAML) const;
 
@@ -437,6 +445,238 @@ namespace VvvfSimulator::Data
             PulseMode pulseMode = PulseMode::PWM;
         };
 
+        /// Compiled/optimized version of the pulse patterns
+        /// Pre-sorts the pattern breakpoints and pre-resolves every region, so
+        /// control frequency queries are a binary search over a flat array that
+        /// returns references instead of copies of PulseControl.
+        /// Answers are the same as the matching Vvvf methods for any pattern order.
+        struct Compiled
+        {
+            /// FunctionValue with its per-call constants folded in. Evaluates
+            /// exactly like YamlVvvfWave::getMovingValue().
+            struct Function
+            {
+                PulseControl::FunctionValue::FunctionType type = PulseControl::FunctionValue::FunctionType::Proportional;
+                double start = 0.0;
+                double end = 1.0;
+                double startValue = 0.0;
+                double endValue = 100.0;
+                double degree = 2.0;
+                /// Proportional: value slope; Inv_Proportional: slope of 1/value;
+                /// Sine: phase slope
+                double slope = 0.0;
+                /// Inv_Proportional: 1/startValue; Sine: phase at start
+                double origin = 0.0;
+                /// Inv_Proportional curve coefficients
+                double a = 0.0, b = 0.0, c = 0.0;
+
+                Function() = default;
+                explicit Function(const PulseControl::FunctionValue& source);
+
+                double operator()(double x) const noexcept;
+            };
+
+            /// A Const/Moving/Table value (amplitude, carrier frequency) as a
+            /// function of the control frequency
+            struct Curve
+            {
+                enum class Kind : uint_fast8_t
+                {
+                    Constant,
+                    Function,
+                    Table
+                };
+
+                Kind kind = Kind::Constant;
+                double constant = 0.0;
+                Compiled::Function function;
+                /// Table mode: ascending (frequency, value) pairs
+                std::vector<std::pair<double, double>> table;
+                bool interpolate = false;
+
+                double operator()(double controlFrequency) const noexcept;
+            };
+
+            /// Pre-resolved parameters of one source pattern
+            struct Region
+            {
+                PulseControl pattern;
+                ControlFrequencyData data;
+                bool isAsync = false;
+                bool requiresCustomPwm = false;
+                Curve amplitude;
+                /// Periodic carriers are time dependent (see Modulation::Carrier);
+                /// their constant is reported here.
+                Curve carrierFrequency;
+            };
+
+            /// Control state a region is resolved for
+            struct State
+            {
+                /// Which enable/stuck flags of a pattern apply
+                enum class Mascon : uint_fast8_t
+                {
+                    Normal,
+                    FreeRunOn,
+                    FreeRunOff
+                };
+
+                double controlFrequency = 0.0;
+                /// Rotation frequency, for rotateFrequencyFrom/Below and stuck patterns
+                double sineFrequency = 0.0;
+                bool brake = false;
+                bool masconOff = false;
+                bool freeRun = false;
+
+                constexpr Mascon mascon() const noexcept
+                {
+                    if (!freeRun)
+                        return Mascon::Normal;
+                    return masconOff ? Mascon::FreeRunOff : Mascon::FreeRunOn;
+                }
+                constexpr bool sameFlags(const State& other) const noexcept
+                {
+                    return brake == other.brake && masconOff == other.masconOff && freeRun == other.freeRun;
+                }
+            };
+
+            /// Lookup table of one pattern list (accelerate or braking)
+            struct Table
+            {
+                /// Breakpoint search over the patterns enabled in one mascon state
+                struct Lookup
+                {
+                    /// Distinct controlFrequencyFrom values of the enabled patterns, ascending
+                    std::vector<double> breakpoints;
+                    /// Region active from each breakpoint up to the next one
+                    std::vector<uint32_t> regionIndex;
+                    /// Region below the lowest breakpoint, if any pattern is enabled
+                    std::optional<uint32_t> first;
+                    /// False if an enabled pattern depends on the rotation frequency
+                    /// (rotation bounds, stuck in this state); find() then scans
+                    bool byControlFrequency = true;
+                };
+
+                /// Distinct controlFrequencyFrom values, ascending
+                std::vector<double> breakpoints;
+                /// Region active from each breakpoint up to the next one
+                std::vector<uint32_t> regionIndex;
+                /// One entry per source pattern, in source order
+                std::vector<Region> regions;
+                /// Indexed by State::Mascon
+                std::array<Lookup, 3> lookups;
+
+                Table() = default;
+                explicit Table(const std::vector<PulseControl>& patterns);
+
+                bool empty() const noexcept { return regions.empty(); }
+                /// Region active at the given frequency regardless of the mascon
+                /// state (as Vvvf's analysis methods), nullptr if there are no patterns
+                const Region* find(double controlFrequency) const noexcept;
+                /// Region active in the given state, nullptr if no pattern is
+                /// enabled in it. Also returns the control frequency interval
+                /// [lower, upper) over which the answer stays the same for the
+                /// same flags; it is empty when the answer also depends on the
+                /// rotation frequency.
+                const Region* find(const State& state, double& lower, double& upper) const noexcept;
+                /// Reference for find(): the region rules applied to each pattern
+                /// in turn, without the lookup
+                const Region* match(const State& state) const noexcept;
+            };
+
+            /// Region and values resolved for a State
+            struct Resolved
+            {
+                const Region* region = nullptr;
+                double amplitude = 0.0;
+                double carrierFrequency = 0.0;
+
+                constexpr bool operator==(const Resolved&) const noexcept = default;
+            };
+
+            /// Incremental resolver for per-sample use. Keeps the active region
+            /// together with the control frequency interval it is valid for, and
+            /// only searches again once the frequency leaves that interval or one
+            /// of the mascon flags changes; otherwise a call costs two comparisons
+            /// plus the region's amplitude/carrier curves. States whose region
+            /// depends on the rotation frequency are searched on every call.
+            /// The Compiled object must outlive the resolver.
+            class Resolver
+            {
+            public:
+                explicit Resolver(const Compiled& compiled) noexcept;
+
+                const Resolved& resolve(const State& state);
+                /// Drop the cached region, e.g. after a seek
+                void invalidate() noexcept;
+
+                /// Compare every incremental answer against Compiled::resolve(),
+                /// which applies the region rules pattern by pattern, and warn on
+                /// mismatches. Defaults to on in debug builds.
+                void setCrossCheck(bool enabled) noexcept { m_crossCheck = enabled; }
+                bool crossCheck() const noexcept { return m_crossCheck; }
+
+                /// Region searches done so far (boundary crossings + invalidations)
+                uint64_t searchCount() const noexcept { return m_searchCount; }
+                uint64_t mismatchCount() const noexcept { return m_mismatchCount; }
+
+            private:
+                const Compiled* m_compiled;
+                State m_state;
+                Resolved m_resolved;
+                double m_lower = 0.0;
+                double m_upper = -1.0; // Empty interval: nothing cached yet
+#ifdef NDEBUG
+                bool m_crossCheck = false;
+#else
+                bool m_crossCheck = true;
+#endif
+                uint64_t m_searchCount = 0;
+                uint64_t m_mismatchCount = 0;
+            };
+
+            int level = 2;
+            Table accelerate;
+            Table braking;
+
+            explicit Compiled(const Vvvf& source);
+
+            // ===== Analysis Methods (same as Vvvf's, without copies) =====
+
+            const ControlFrequencyData& getControlFrequencyData(double controlFrequency) const noexcept;
+            const PulseControl* getCurrentAcceleratePattern(double controlFrequency) const noexcept;
+            const PulseControl* getCurrentBrakingPattern(double controlFrequency) const noexcept;
+            bool requiresCustomPwm(double controlFrequency) const noexcept;
+            double getAmplitude(double controlFrequency) const noexcept;
+            PulseMode getPulseMode(double controlFrequency) const noexcept;
+            double getCarrierFrequency(double controlFrequency) const noexcept;
+            bool isAsyncMode(double controlFrequency) const noexcept;
+            int getBipolar(double controlFrequency) const noexcept;
+
+            /// Full (non-incremental) resolution: the braking patterns while
+            /// braking and the accelerating ones otherwise, falling back to the
+            /// other list if one is empty. Within the list, the last pattern in
+            /// source order that
+            /// - is enabled in the current state (enableNormal, enableFreeRunOn
+            ///   or enableFreeRunOff),
+            /// - has the rotation frequency within [rotateFrequencyFrom,
+            ///   rotateFrequencyBelow) (negative bounds are unset) and
+            /// - starts at or below the control frequency, or at or below the
+            ///   rotation frequency if it is stuck in the current free-run state
+            /// is chosen; failing that, the first enabled pattern within its
+            /// rotation bounds.
+            Resolved resolve(const State& state) const noexcept;
+
+        private:
+            /// Region getControlFrequencyData() resolves from, nullptr if none
+            const Region* findDataRegion(double controlFrequency) const noexcept;
+            /// Pattern list resolve() searches for the given state
+            const Table& selectTable(const State& state) const noexcept;
+
+            /// Returned when there are no patterns at all
+            ControlFrequencyData m_fallback;
+        };
+
         // Backward compatibility aliases
         using YamlVvvfSoundData = Vvvf;
         using YamlControlData = Vvvf::PulseControl;
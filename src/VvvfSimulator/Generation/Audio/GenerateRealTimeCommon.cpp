@@ -3,10 +3,25 @@
 // Standard Library
 #include <algorithm>
 // Internal
+#include "RingWaveIODevice.hpp"
 #include "../../Yaml/MasconControl/YamlMasconAnalyze.hpp"
 
 namespace VvvfSimulator::Generation::Audio::GenerateRealTimeCommon
 {
+	void RealTimeParameter::requestQuit()
+	{
+		quit = true;
+		// The lock keeps the device alive until the wake-up is delivered
+		std::lock_guard lock(m_providerMutex);
+		if (m_provider) m_provider->wakeProducer();
+	}
+
+	void RealTimeParameter::setProvider(RingWaveIODevice *device)
+	{
+		std::lock_guard lock(m_providerMutex);
+		m_provider = device;
+	}
+
 	int realTimeFrequencyControl(VvvfValues &control, const RealTimeParameter &param, double dt)
 	{
 		control.brake = param.isBraking;
@@ -1,5 +1,8 @@
 #pragma once
 
+// Standard Library
+#include <atomic>
+#include <mutex>
 // Packages
 #include <QAudioDevice>
 #include <QPointer>
@@ -10,6 +13,11 @@
 #include "../../Yaml/VehicleAudioSetting/YamlVehicleSoundAnalyze.hpp"
 #include "../../Yaml/VvvfSound/YamlVvvfAnalyze.hpp"
 
+namespace VvvfSimulator::Generation::Audio
+{
+	class RingWaveIODevice;
+}
+
 namespace VvvfSimulator::Generation::Audio::GenerateRealTimeCommon
 {
 	using Vvvf::Struct::VvvfValues;
@@ -26,9 +34,22 @@ namespace VvvfSimulator::Generation::Audio::GenerateRealTimeCommon
 		YamlVehicleSoundData vehicleSoundData;
 		QPointer<QAudioDevice> audioDevice;
 		bool isBraking = false;
-		bool quit = false;
+		// Read by the generator thread; set it through requestQuit()
+		std::atomic<bool> quit = false;
 		bool isFreeRunning = false;
 
+		/*
+		@brief Makes the generator stop, waking it right away if it is waiting
+		for the audio sink to drain its buffer.
+		*/
+		void requestQuit();
+		/// Registers (or, with nullptr, clears) the buffer the generator waits on.
+		void setProvider(RingWaveIODevice *device);
+
+	private:
+		std::mutex m_providerMutex;
+		RingWaveIODevice *m_provider = nullptr;
+
 		#define TEMP sizeof(VvvfSimulator::Generation::Audio::RealTimeParameter)
 	};
 
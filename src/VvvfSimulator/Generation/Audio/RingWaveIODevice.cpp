@@ -0,0 +1,138 @@
+#include "RingWaveIODevice.hpp"
+// Standard Library
+#include <cstring>
+
+namespace VvvfSimulator::Generation::Audio
+{
+	RingWaveIODevice::RingWaveIODevice(
+		const QAudioFormat &fmt,
+		size_type capacity,
+		bool readFully,
+		QObject *parent
+	)
+		: QIODevice(parent)
+		, m_fmt(fmt)
+		, m_readFully(readFully)
+		, m_ring(capacity)
+	{
+		Q_ASSERT(m_fmt.sampleFormat() == QAudioFormat::Unknown || m_fmt.sampleFormat() == QAudioFormat::Float);
+		open(QIODevice::ReadWrite | QIODevice::Unbuffered);
+	}
+
+	RingWaveIODevice::~RingWaveIODevice() = default;
+
+	qint64 RingWaveIODevice::bytesAvailable() const
+	{
+		return bufferedBytes() + QIODevice::bytesAvailable();
+	}
+
+	bool RingWaveIODevice::isSequential() const { return true; }
+
+	RingWaveIODevice::size_type RingWaveIODevice::bufferedSamples() const noexcept
+	{
+		// A third thread can load the head before the consumer moves the tail
+		// past it, which wraps the difference around
+		const size_type size = m_ring.size();
+		return size > m_ring.capacity() ? 0 : size;
+	}
+
+	RingWaveIODevice::size_type RingWaveIODevice::addSamples(std::span<const float> samples)
+	{
+		const size_type written = m_ring.push(samples);
+		if (written < samples.size())
+		{
+			m_overruns.fetch_add(1, std::memory_order_relaxed);
+			m_droppedSamples.fetch_add(samples.size() - written, std::memory_order_relaxed);
+		}
+		return written;
+	}
+
+	bool RingWaveIODevice::waitForBufferedAtMost(size_type level, std::chrono::milliseconds timeout)
+	{
+		if (m_ring.size() <= level) return true;
+
+		std::unique_lock lock(m_waitMutex);
+		// Publish the wanted level before re-checking, so a consumer draining
+		// the ring in between either sees it or is seen by the predicate. This
+		// is a store followed by a load of another location (the ring tail),
+		// mirrored in readData(); only full fences on both sides keep the two
+		// from both missing each other.
+		m_waitLevel.store(level, std::memory_order_seq_cst);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const bool reached = m_waitCondition.wait_for(lock, timeout, [&]() {
+			return m_ring.size() <= level || m_waitLevel.load(std::memory_order_relaxed) == NoWaiter;
+		});
+		m_waitLevel.store(NoWaiter, std::memory_order_relaxed);
+		return reached && m_ring.size() <= level;
+	}
+
+	void RingWaveIODevice::wakeProducer()
+	{
+		{
+			std::lock_guard lock(m_waitMutex);
+			m_waitLevel.store(NoWaiter, std::memory_order_relaxed);
+		}
+		m_waitCondition.notify_all();
+	}
+
+	RingWaveIODevice::Statistics RingWaveIODevice::statistics() const noexcept
+	{
+		return {
+			m_underruns.load(std::memory_order_relaxed),
+			m_overruns.load(std::memory_order_relaxed),
+			m_paddedSamples.load(std::memory_order_relaxed),
+			m_droppedSamples.load(std::memory_order_relaxed)
+		};
+	}
+
+	void RingWaveIODevice::resetStatistics() noexcept
+	{
+		m_underruns.store(0, std::memory_order_relaxed);
+		m_overruns.store(0, std::memory_order_relaxed);
+		m_paddedSamples.store(0, std::memory_order_relaxed);
+		m_droppedSamples.store(0, std::memory_order_relaxed);
+	}
+
+	bool RingWaveIODevice::setReadFully(const bool rf)
+	{
+		m_readFully = rf;
+		return true;
+	}
+
+	qint64 RingWaveIODevice::readData(char *data, qint64 maxLen)
+	{
+		// The sink only ever asks for whole frames, but don't rely on it.
+		const size_type requested = size_type(maxLen) / sizeof(float);
+		const size_type read = m_ring.pop({reinterpret_cast<float *>(data), requested});
+
+		// Pairs with the fence in waitForBufferedAtMost(): orders the tail
+		// published by pop() before the read of the waiting level.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (const size_type level = m_waitLevel.load(std::memory_order_seq_cst); level != NoWaiter && m_ring.size() <= level)
+		{
+			// Taking the lock orders this notification after the producer
+			// either started waiting or saw the new fill level.
+			{ std::lock_guard lock(m_waitMutex); }
+			m_waitCondition.notify_one();
+		}
+
+		if (read < requested)
+		{
+			m_underruns.fetch_add(1, std::memory_order_relaxed);
+			if (!m_readFully) return qint64(read * sizeof(float));
+
+			m_paddedSamples.fetch_add(requested - read, std::memory_order_relaxed);
+			std::memset(data + read * sizeof(float), 0, size_t(maxLen) - read * sizeof(float));
+			return maxLen;
+		}
+
+		return qint64(read * sizeof(float));
+	}
+
+	qint64 RingWaveIODevice::writeData(const char *data, qint64 len)
+	{
+		const size_type count = size_type(len) / sizeof(float);
+		// Anything past the last whole sample can't be represented; drop it.
+		return qint64(addSamples({reinterpret_cast<const float *>(data), count}) * sizeof(float));
+	}
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+// Standard Library
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <span>
+// Packages
+#include <QAudioFormat>
+#include <QIODevice>
+// Internal
+#include "../Util/SpscRingBuffer.hpp"
+
+namespace VvvfSimulator::Generation::Audio
+{
+	/*
+	@brief QIODevice adapter over a lock-free float ring, meant to sit between
+	a real-time generator thread (producer) and a QAudioSink pulling from it
+	(consumer). Neither side blocks the other nor allocates after construction.
+
+	Samples are written with addSamples() (or QIODevice::write() with raw
+	float data) and read as raw float bytes by the audio sink.
+	*/
+	class RingWaveIODevice : public QIODevice
+	{
+		Q_OBJECT
+		Q_PROPERTY(bool readFully READ readFully WRITE setReadFully)
+
+	public:
+		using size_type = Util::SpscRingBuffer<float>::size_type;
+
+		/// Glitch counters, readable from any thread.
+		struct Statistics
+		{
+			quint64 underruns = 0;      // Reads the ring couldn't fully serve
+			quint64 overruns = 0;       // Writes the ring couldn't fully take
+			quint64 paddedSamples = 0;  // Silence inserted on underruns
+			quint64 droppedSamples = 0; // Samples discarded on overruns
+		};
+
+		/*
+		@param fmt Format reported to the sink; must be mono float.
+		@param capacity Minimum capacity in samples, rounded up to a power of
+		two.
+		@param readFully If true, reads shorter than requested are padded with
+		silence so the sink never starves. Short reads count as an underrun
+		either way.
+		*/
+		explicit RingWaveIODevice(
+			const QAudioFormat &fmt = QAudioFormat(),
+			size_type capacity = 16384,
+			bool readFully = true,
+			QObject *parent = nullptr
+		);
+		~RingWaveIODevice() override;
+
+		// QIODevice interface implementation
+		qint64 bytesAvailable() const override;
+		bool isSequential() const override;
+
+		// ===== Producer side =====
+		/*
+		@returns How many samples were queued; the rest were dropped and
+		counted as an overrun.
+		*/
+		size_type addSamples(std::span<const float> samples);
+		size_type writeAvailable() const noexcept { return m_ring.writeAvailable(); }
+		/*
+		@brief Blocks the producer until the consumer has drained the ring down
+		to at most the given amount of buffered samples, or the timeout passes.
+		The wait is woken by readData(), so a waiting producer costs no CPU.
+
+		@returns True if the fill level is at most level on return.
+		*/
+		bool waitForBufferedAtMost(size_type level, std::chrono::milliseconds timeout);
+		/// Wakes a producer blocked in waitForBufferedAtMost(), e.g. on quit.
+		void wakeProducer();
+
+		// ===== Any thread =====
+		/*
+		@brief Exact from the producer or the consumer thread. Other threads
+		may see the two ends out of order, so there it is only an estimate,
+		clamped to [0, capacity()].
+		*/
+		size_type bufferedSamples() const noexcept;
+		qint64 bufferedBytes() const noexcept { return qint64(bufferedSamples() * sizeof(float)); }
+		constexpr size_type capacity() const noexcept { return m_ring.capacity(); }
+		Statistics statistics() const noexcept;
+		void resetStatistics() noexcept;
+
+		constexpr bool readFully() const noexcept { return m_readFully; }
+		constexpr const QAudioFormat &waveFormatRef() const noexcept { return m_fmt; }
+
+	public slots:
+		bool setReadFully(const bool rf);
+
+	protected:
+		qint64 readData(char *data, qint64 maxLen) override;
+		qint64 writeData(const char *data, qint64 len) override;
+
+	private:
+		QAudioFormat m_fmt;
+		bool m_readFully;
+		Util::SpscRingBuffer<float> m_ring;
+		// Producer written
+		std::atomic<quint64> m_overruns{0}, m_droppedSamples{0};
+		// Back-pressure. The consumer only touches the mutex while a producer
+		// is actually waiting (m_waitLevel below its sentinel value).
+		static constexpr size_type NoWaiter = ~size_type(0);
+		std::atomic<size_type> m_waitLevel{NoWaiter};
+		std::mutex m_waitMutex;
+		std::condition_variable m_waitCondition;
+		// Consumer written
+		alignas(Util::SpscRingBuffer<float>::CacheLineSize)
+		std::atomic<quint64> m_underruns{0}, m_paddedSamples{0};
+	};
+}
@@ -1,7 +1,9 @@
 #include "Audio.hpp"
 // Standard Library
+#include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <memory>
 #include <optional>
 #include <string>
 // Packages
@@ -10,9 +12,11 @@
 #include <QAudioDecoder>
 #include <QDateTime>
 #include <QDebug>
+#include <QEventLoop>
 #include <QObject>
 #include <QUrl>
 // Internal
+#include "ParallelRender.hpp"
 #include "../../../Vvvf/Calculate.hpp"
 #include "../../../Yaml/VvvfSound/YamlVvvfWave.hpp"
 
@@ -68,17 +72,30 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::Audio
 		if (!m_isRunning) return -1;
 
 		qint64 retVal = sample.size();
-		m_Buffer->write(sample.constData(), retVal);
+		// Whole sample blocks may not fit in what is left of the buffer; make
+		// room first instead of letting the circular buffer drop the excess.
+		if (m_Buffer->size() + sample.size() > m_Buffer->maxSize())
+			if (const qint64 ret2 = flushBuffer(); ret2 > 0) retVal += ret2;
+		// Blocks at least as large as the buffer itself skip it altogether.
+		if (sample.size() >= m_Buffer->maxSize())
+			return m_file.write(sample.constData(), sample.size()) < 0 ? -1 : retVal;
 
-		if (const qint64 size = m_Buffer->size(); size >= m_Buffer->maxSize())
-		{
-			const QByteArray data = m_Buffer->read(size);
-			if (const qint64 ret2 = m_file.write(data); ret2 > 0) retVal += ret2;
-		}
+		m_Buffer->write(sample.constData(), sample.size());
+
+		if (m_Buffer->size() >= m_Buffer->maxSize())
+			if (const qint64 ret2 = flushBuffer(); ret2 > 0) retVal += ret2;
 
 		return retVal;
 	}
 
+	qint64 BufferedWaveFileWriter::flushBuffer()
+	{
+		const qint64 size = m_Buffer->size();
+		if (size == 0) return 0;
+		const QByteArray data = m_Buffer->read(size);
+		return m_file.write(data);
+	}
+
 	void BufferedWaveFileWriter::close()
 	{
 		// Stop if running
@@ -217,17 +234,20 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::Audio
 				error = QObject::tr("Audio decoding error: %1").arg(decoder.errorString());
 			});
 
-			volatile bool finished = false;
+			// Sleep in a local event loop (which also delivers the decoder's
+			// signals) until decoding ends, instead of spinning on a flag.
+			QEventLoop loop;
 			bool retVal = true;
-			QObject::connect(&decoder, &QAudioDecoder::finished, [&]() {
+			QObject::connect(&decoder, &QAudioDecoder::finished, &loop, [&]() {
 				outFile.close();
 				if (deleteOld)
 					if (!QFile::remove(inputPath)) retVal = false;
-				finished = true;
+				loop.quit();
 			});
+			QObject::connect(&decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), &loop, &QEventLoop::quit);
 
 			decoder.start();
-			while (!finished);
+			if (decoder.isDecoding()) loop.exec();
 			if (error) return *error;
 			// else
 			return retVal;
@@ -238,65 +258,221 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::Audio
 		}
 	}
 	void exportWavFile(GenerationCommon::GenerationBasicParameter genParam, GetSampleFunctional getSample, int samplingFreq, bool useRaw, const std::filesystem::path& Path)
+	{
+		// Adapts the per-sample generator to the block interface. Multichannel
+		// (or empty) results are flattened, so the block may hold more or less
+		// than one value per time step; keep the leftovers for the next call.
+		struct Pending
+		{
+			std::vector<float> samples;
+			size_t next = 0; // First sample not handed out yet
+			bool lastStep = false;
+		};
+		auto pending = std::make_shared<Pending>();
+		GetSampleBlockFunctional blockGen = [getSample = std::move(getSample), pending](
+			NAMESPACE_VVVF::Struct::VvvfValues &control,
+			GenerationCommon::GenerationBasicParameter &genParam,
+			double dt,
+			std::span<float> out,
+			bool &finished
+		) -> qsizetype
+		{
+			qsizetype written = 0;
+			while (written < qsizetype(out.size()))
+			{
+				if (pending->next == pending->samples.size())
+				{
+					if (pending->lastStep) break;
+					control.sinTime += dt;
+					control.sawTime += dt;
+					pending->samples = getSample(control, genParam.soundData);
+					pending->next = 0;
+					genParam.progress.progress++;
+					pending->lastStep = genParam.progress.cancel || !genParam.masconData.checkForFreqChange(control, genParam.soundData, dt);
+					continue;
+				}
+				const qsizetype count = std::min<qsizetype>(pending->samples.size() - pending->next, out.size() - written);
+				std::copy_n(pending->samples.begin() + pending->next, count, out.begin() + written);
+				pending->next += count;
+				written += count;
+			}
+			finished = pending->lastStep && pending->next == pending->samples.size();
+			return written;
+		};
+		return exportWavFile(std::move(genParam), std::move(blockGen), samplingFreq, useRaw, Path);
+	}
+
+	namespace
 	{
 		constexpr float volumeFactor = 0.35f;
-		const double dt = 1.0 / samplingFreq;
-		genParam.progress.total = genParam.masconData.getEstimatedSteps(dt);
-		if (!useRaw)
+
+		/*
+		Shared by the exporters: sets up the progress and the (temporary)
+		destination, lets produce() write every sample through the writer and
+		down-samples the result unless the raw output was requested.
+		*/
+		void exportWavFileWith(
+			GenerationCommon::GenerationBasicParameter &genParam,
+			int samplingFreq,
+			bool useRaw,
+			const std::filesystem::path &Path,
+			const std::function<void(GenerationCommon::GenerationBasicParameter &, double, BufferedWaveFileWriter &)> &produce
+		)
 		{
-			size_t pathEntryListSize = 0;
-			for (auto it = Path.begin(); it != Path.end(); it++) pathEntryListSize++;
-			genParam.progress.total *= std::pow(1.04, pathEntryListSize);
-		}
+			const double dt = 1.0 / samplingFreq;
+			genParam.progress.total = genParam.masconData.getEstimatedSteps(dt);
+			if (!useRaw)
+			{
+				size_t pathEntryListSize = 0;
+				for (auto it = Path.begin(); it != Path.end(); it++) pathEntryListSize++;
+				genParam.progress.total *= std::pow(1.04, pathEntryListSize);
+			}
 
-		NAMESPACE_VVVF::Struct::VvvfValues control{};
-		constexpr int downSampledFrequency = 44100;
+			constexpr int downSampledFrequency = 44100;
 
-		const std::filesystem::path exportPath = useRaw ? Path : (Path
-			/ QDateTime::currentDateTime().toString(QStringLiteral(
-				"yyyyMMddhhmmss")
-			).toStdU16String())
-			/ ".temp";
-		BufferedWaveFileWriter writer(exportPath, samplingFreq, -1);
+			const std::filesystem::path exportPath = useRaw ? Path : (Path
+				/ QDateTime::currentDateTime().toString(QStringLiteral(
+					"yyyyMMddhhmmss")
+				).toStdU16String())
+				/ ".temp";
+			BufferedWaveFileWriter writer(exportPath, samplingFreq, -1);
 
-		bool loop = true;
-		while (loop)
-		{
-			control.sinTime += dt;
-			control.sawTime += dt;
-			std::vector<float> samples = getSample(control, genParam.soundData);
-
-			for (const float &sample : samples) writer.addSample({sample * volumeFactor});
-			genParam.progress.progress++;
-			bool flagContinue = genParam.masconData.checkForFreqChange(control, genParam.soundData, 1.0 / samplingFreq);
-			loop = !genParam.progress.cancel && flagContinue;
+			produce(genParam, dt, writer);
+
+			writer.close();
+			if (!useRaw)
+			{
+				const auto in = exportPath.u16string();
+				const QString input = QString::fromRawData(reinterpret_cast<const QChar *>(in.data()), in.size());
+				reSample(downSampledFrequency, input, Path, true);
+				genParam.progress.progress *= 1.05;
+			}
+
+			genParam.progress.progress = genParam.progress.total;
 		}
 
-		writer.close();
-		if (!useRaw)
+		qint64 addScaledSamples(BufferedWaveFileWriter &writer, std::span<float> block)
 		{
-			const auto in = exportPath.u16string();
-			const QString input = QString::fromRawData(reinterpret_cast<const QChar *>(in.data()), in.size());
-			reSample(downSampledFrequency, input, Path, true);
-			genParam.progress.progress *= 1.05;
+			for (float &sample : block) sample *= volumeFactor;
+			return writer.addSample(QByteArrayView(
+				reinterpret_cast<const char *>(block.data()),
+				block.size() * sizeof(float) / sizeof(char))
+			);
 		}
+	}
 
-		genParam.progress.progress = genParam.progress.total;
+	void exportWavFile(GenerationCommon::GenerationBasicParameter genParam, GetSampleBlockFunctional getSampleBlock, int samplingFreq, bool useRaw, const std::filesystem::path& Path, qsizetype blockSize)
+	{
+		exportWavFileWith(genParam, samplingFreq, useRaw, Path, [&getSampleBlock, blockSize](
+			GenerationCommon::GenerationBasicParameter &genParam,
+			double dt,
+			BufferedWaveFileWriter &writer
+		)
+		{
+			NAMESPACE_VVVF::Struct::VvvfValues control{};
+			// Allocated once; every block is generated into and written from here.
+			std::vector<float> block(std::max<qsizetype>(blockSize, 1));
+			bool finished = false;
+			while (!finished)
+			{
+				const qsizetype count = getSampleBlock(control, genParam, dt, block, finished);
+				addScaledSamples(writer, std::span<float>(block.data(), count));
+			}
+		});
+	}
+
+	void exportWavFile(GenerationCommon::GenerationBasicParameter genParam, ParallelRender::SampleKernel kernel, int samplingFreq, bool useRaw, const std::filesystem::path& Path, const ParallelRender::Options &options)
+	{
+		exportWavFileWith(genParam, samplingFreq, useRaw, Path, [kernel, &options](
+			GenerationCommon::GenerationBasicParameter &genParam,
+			double dt,
+			BufferedWaveFileWriter &writer
+		)
+		{
+			std::vector<float> scaled;
+			ParallelRender::render(genParam, dt, kernel, [&writer, &scaled](std::span<const float> block)
+			{
+				scaled.assign(block.begin(), block.end());
+				addScaledSamples(writer, scaled);
+			}, options);
+		});
+	}
+
+	float lineSample(NAMESPACE_VVVF::Struct::VvvfValues &control, const NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData &soundData)
+	{
+		NAMESPACE_VVVF::Struct::PwmCalculateValues calculatedValues = Yaml::VvvfSound::YamlVvvfWave::calculateYaml(control, soundData);
+		NAMESPACE_VVVF::Struct::WaveValues value = Vvvf::Calculate::calculatePhases(control, calculatedValues, 0);
+		double pwmValue = (2.0 * value.U - value.V - value.W) * (const double)(1.0 / 8.0);
+		return static_cast<float>(pwmValue);
 	}
 
 	void exportWavLine(GenerationCommon::GenerationBasicParameter genParam, int samplingFreq, bool useRaw, const std::filesystem::path &Path)
 	{
-		static const GetSampleFunctional sampleGen = [](
-			NAMESPACE_VVVF::Struct::VvvfValues &control,
-			const NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData &soundData
-		) -> std::vector<float>
+		return exportWavFile(genParam, &lineSample, samplingFreq, useRaw, Path);
+	}
+
+	namespace Benchmark
+	{
+		Util::Benchmark::Throughput measureLineSampleThroughput(
+			const GenerationCommon::GenerationBasicParameter &genParam,
+			int samplingFreq,
+			qsizetype sampleCount,
+			qsizetype blockSize
+		)
 		{
-			NAMESPACE_VVVF::Struct::PwmCalculateValues calculatedValues = Yaml::VvvfSound::YamlVvvfWave::calculateYaml(control, soundData);
-			NAMESPACE_VVVF::Struct::WaveValues value = Vvvf::Calculate::calculatePhases(control, calculatedValues, 0);
-			double pwmValue = (2.0 * value.U - value.V - value.W) * (const double)(1.0 / 8.0);
-			return { static_cast<float>(pwmValue) };
-		};
-		return exportWavFile(genParam, sampleGen, samplingFreq, useRaw, Path);
+			const double dt = 1.0 / samplingFreq;
+			Util::Benchmark::Throughput result;
+
+			// Reference: the per-sample path, one std::function call and one
+			// std::vector per sample, appended one at a time.
+			{
+				auto param = genParam;
+				NAMESPACE_VVVF::Struct::VvvfValues control{};
+				const GetSampleFunctional getSample = [](
+					NAMESPACE_VVVF::Struct::VvvfValues &control,
+					const NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData &soundData
+				) -> std::vector<float>
+				{
+					return { lineSample(control, soundData) };
+				};
+				QVector<float> sink;
+				sink.reserve(sampleCount);
+
+				result.beforeRate = Util::Benchmark::measureRate([&]() -> qsizetype
+				{
+					bool loop = true;
+					while (loop && sink.size() < sampleCount)
+					{
+						control.sinTime += dt;
+						control.sawTime += dt;
+						for (const float &sample : getSample(control, param.soundData)) sink.append(sample);
+						loop = param.masconData.checkForFreqChange(control, param.soundData, dt);
+					}
+					return sink.size();
+				}, &result.items);
+			}
+			// Block path, generating straight into a preallocated buffer.
+			{
+				auto param = genParam;
+				NAMESPACE_VVVF::Struct::VvvfValues control{};
+				std::vector<float> sink(sampleCount);
+
+				result.afterRate = Util::Benchmark::measureRate([&]() -> qsizetype
+				{
+					qsizetype total = 0;
+					bool finished = false;
+					while (!finished && total < sampleCount)
+					{
+						const std::span<float> block(sink.data() + total, std::min(blockSize, sampleCount - total));
+						total += fillSampleBlock(control, param, dt, block, finished, lineSample);
+					}
+					return total;
+				});
+			}
+
+			Util::Benchmark::report("Line sample throughput", result, "per sample", "per block");
+			return result;
+		}
 	}
 } // namespace VvvfSimulator::Generation::Audio::VvvfSound::Audio
 
@@ -1,5 +1,6 @@
 // Internal Includes
 #include "../BufferedWaveIODevice.hpp"
+#include "ParallelRender.hpp"
 #include "../../GenerateCommon.hpp"
 #include "../../../Outcome.hpp"
 #include "../../../Vvvf/Struct.hpp"
@@ -8,6 +9,7 @@
 #include <filesystem>
 #include <functional>
 #include <optional>
+#include <span>
 #include <vector>
 // Package Includes
 #include <QAudioFormat>
@@ -22,6 +24,7 @@
 #include <QScopedPointer>
 #include <QString>
 // Internal
+#include "../../../Util/Benchmark.hpp"
 #include "../../../Util/String.hpp"
 
 namespace VvvfSimulator::Generation::Audio::VvvfSound::Audio
@@ -36,6 +39,8 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::Audio
 		VvvfSimulator::Util::String::TranslatableFmtString m_warning;
 		bool m_isWarnLast = true, m_isRunning = false;
 
+		qint64 flushBuffer();
+
 	public:
 		/*
 		@brief Make a new BufferedWaveFileWriter object.
@@ -157,8 +162,100 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::Audio
 		const NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData &
 	)>;
 
-	static void exportWavFile(GenerationCommon::GenerationBasicParameter genParam, GetSampleFunctional getSample, int samplingFreq, bool useRaw, const std::filesystem::path& Path);
+	/*
+	@brief Fills a caller-provided block of mono samples, one per time step.
+
+	The modulation state lives in the VvvfValues object, so consecutive calls
+	continue exactly where the previous block stopped. Implementations are
+	expected to advance sinTime/sawTime and the mascon timeline themselves
+	(see fillSampleBlock()).
+
+	@returns How many samples were written to the block. The last parameter
+	is set to true once the mascon timeline ended (or the generation was
+	cancelled); the block then holds the final samples of the generation.
+	*/
+	using GetSampleBlockFunctional = std::function<qsizetype(
+		NAMESPACE_VVVF::Struct::VvvfValues &,
+		GenerationCommon::GenerationBasicParameter &,
+		double,
+		std::span<float>,
+		bool &
+	)>;
+
+	/// Samples generated per GetSampleBlockFunctional call by the exporters.
+	inline constexpr qsizetype DefaultSampleBlockSize = 4096;
+
+	/*
+	@brief Generic block driver shared by the block generators.
+
+	Runs the same per-sample time step as the original per-sample loop
+	(advance time, evaluate, check the mascon timeline), but with the kernel
+	inlined into the loop instead of going through a std::function and a
+	heap-allocated std::vector for every single sample.
+
+	@param kernel Callable with the signature
+	float(VvvfValues &, const YamlVvvfSoundData &).
+	*/
+	template <typename SampleKernel>
+	qsizetype fillSampleBlock(
+		NAMESPACE_VVVF::Struct::VvvfValues &control,
+		GenerationCommon::GenerationBasicParameter &genParam,
+		double dt,
+		std::span<float> out,
+		bool &finished,
+		SampleKernel &&kernel
+	)
+	{
+		qsizetype written = 0;
+		for (float &sample : out)
+		{
+			if (finished) break;
+			control.sinTime += dt;
+			control.sawTime += dt;
+			sample = kernel(control, genParam.soundData);
+			written++;
+			genParam.progress.progress++;
+			finished = genParam.progress.cancel || !genParam.masconData.checkForFreqChange(control, genParam.soundData, dt);
+		}
+		return written;
+	}
+
+	void exportWavFile(GenerationCommon::GenerationBasicParameter genParam, GetSampleFunctional getSample, int samplingFreq, bool useRaw, const std::filesystem::path& Path);
+	void exportWavFile(GenerationCommon::GenerationBasicParameter genParam, GetSampleBlockFunctional getSampleBlock, int samplingFreq, bool useRaw, const std::filesystem::path& Path, qsizetype blockSize = DefaultSampleBlockSize);
+	/*
+	@brief Exports a mono sample kernel through ParallelRender::render(), i.e.
+	in parallel chunks whenever the sound allows it. The file is identical to
+	the one produced by the serial exporters.
+	*/
+	void exportWavFile(GenerationCommon::GenerationBasicParameter genParam, ParallelRender::SampleKernel kernel, int samplingFreq, bool useRaw, const std::filesystem::path& Path, const ParallelRender::Options &options = {});
 
 //	public:
-	static void exportWavLine(GenerationCommon::GenerationBasicParameter genParam, int samplingFreq, bool useRaw, const std::filesystem::path& Path);
+	void exportWavLine(GenerationCommon::GenerationBasicParameter genParam, int samplingFreq, bool useRaw, const std::filesystem::path& Path);
+
+	/*
+	@brief Line voltage (U-V) sample kernel used by exportWavLine().
+	*/
+	float lineSample(NAMESPACE_VVVF::Struct::VvvfValues &control, const NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData &soundData);
+
+	namespace Benchmark
+	{
+		/*
+		@brief Measures the sample generation throughput of the line voltage
+		generator, comparing the per-sample (before) and the block based
+		(after) paths. No file is written; the samples are only accumulated
+		into memory, so the result reflects the generation cost alone.
+		Run from the command line with --batch --benchmark line-sample.
+
+		@param genParam Generation parameters; both runs start from a copy.
+		@param samplingFreq In Hertz (Hz).
+		@param sampleCount Upper bound of samples generated per path. Stops
+		earlier if the mascon timeline ends first.
+		*/
+		Util::Benchmark::Throughput measureLineSampleThroughput(
+			const GenerationCommon::GenerationBasicParameter &genParam,
+			int samplingFreq,
+			qsizetype sampleCount,
+			qsizetype blockSize = DefaultSampleBlockSize
+		);
+	}
 }
@@ -0,0 +1,255 @@
+#include "ParallelRender.hpp"
+// Standard Library
+#include <algorithm>
+#include <cstring>
+#include <utility>
+// Packages
+#include <QDebug>
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+// Internal
+#include "Audio.hpp"
+#include "../../../Yaml/VvvfSound/YamlVvvfWave.hpp"
+
+namespace VvvfSimulator::Generation::Audio::VvvfSound::ParallelRender
+{
+	using NAMESPACE_VVVF::Struct::VvvfValues;
+	using NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData;
+
+	bool carriesState(const YamlVvvfSoundData::YamlControlData &data)
+	{
+		using PulseTypeName = YamlVvvfSoundData::YamlControlData::YamlPulseMode::PulseTypeName;
+		return data.PulseMode.PulseType == PulseTypeName::ASYNC;
+	}
+
+	bool isChunkable(const YamlVvvfSoundData &soundData)
+	{
+		const auto isStateless = [](const YamlVvvfSoundData::YamlControlData &data) { return !carriesState(data); };
+		return std::any_of(soundData.AcceleratePattern.cbegin(), soundData.AcceleratePattern.cend(), isStateless)
+			|| std::any_of(soundData.BrakingPattern.cbegin(), soundData.BrakingPattern.cend(), isStateless);
+	}
+
+	ChunkPlanner::ChunkPlanner(
+		const GenerationCommon::GenerationBasicParameter &genParam,
+		const VvvfValues &initial,
+		double dt,
+		qsizetype chunkSamples,
+		SampleKernel kernel
+	)
+		: m_genParam(genParam)
+		, m_control(initial)
+		, m_dt(dt)
+		, m_chunkSamples(std::max<qsizetype>(chunkSamples, 1))
+		, m_kernel(kernel)
+	{
+		for (size_t brake = 0; brake < 2; brake++)
+		{
+			const auto &patterns = brake ? genParam.soundData.BrakingPattern : genParam.soundData.AcceleratePattern;
+			m_searchEnd[brake] = static_cast<size_t>(patterns.crend() - std::find_if(patterns.crbegin(), patterns.crend(), carriesState));
+			m_allStateful[brake] = !patterns.empty() && std::all_of(patterns.cbegin(), patterns.cend(), carriesState);
+		}
+	}
+
+	bool ChunkPlanner::isStateful()
+	{
+		// Same pattern lookup as calculateYaml(); it only reads the control
+		// and rotation frequencies and the mascon flags, which the time step
+		// leaves alone. A sample wrongly taken as stateful is still exact,
+		// only rendered serially, so a list of stateful patterns only needs no
+		// search at all.
+		const size_t list = m_control.brake ? 1 : 0;
+		if (m_searchEnd[list] == 0) return false;
+		if (m_allStateful[list]) return true;
+
+		const Lookup lookup{ m_control.controlFrequency, m_control.sinAngleFreq, m_control.brake, m_control.masconOff, m_control.freeRun };
+		if (m_lookupValid && lookup.controlFrequency == m_lookup.controlFrequency && lookup.sinAngleFreq == m_lookup.sinAngleFreq
+			&& lookup.brake == m_lookup.brake && lookup.masconOff == m_lookup.masconOff && lookup.freeRun == m_lookup.freeRun)
+			return m_lookup.stateful;
+
+		const auto &patterns = m_control.brake ? m_genParam.soundData.BrakingPattern : m_genParam.soundData.AcceleratePattern;
+		const auto end = patterns.cbegin() + m_searchEnd[list];
+		const auto match = std::find_if(patterns.cbegin(), end, [this](const YamlVvvfSoundData::YamlControlData &data)
+		{
+			return Yaml::VvvfSound::YamlVvvfWave::isMatching(m_control, data);
+		});
+		m_lookup = lookup;
+		m_lookup.stateful = match != end && carriesState(*match);
+		m_lookupValid = true;
+		return m_lookup.stateful;
+	}
+
+	void ChunkPlanner::replayRunEnd()
+	{
+		// The run's control pass again, from its snapshot, with the kernel
+		// evaluated on its last sample; renderChunk() produces that sample's
+		// output, only the state it leaves behind is kept here
+		VvvfValues &scratch = m_run.control;
+		for (qsizetype i = 1; i <= m_run.sampleCount; i++)
+		{
+			scratch.sinTime += m_dt;
+			scratch.sawTime += m_dt;
+			if (i == m_run.sampleCount) m_kernel(scratch, m_genParam.soundData);
+			m_genParam.masconData.checkForFreqChange(scratch, m_genParam.soundData, m_dt);
+		}
+		m_control = std::move(scratch);
+		m_deferring = false;
+	}
+
+	bool ChunkPlanner::next(Chunk &chunk)
+	{
+		if (m_finished) return false;
+
+		chunk.firstSample = m_nextSample;
+		chunk.deferred.clear();
+		chunk.samples.resize(m_chunkSamples);
+
+		// Same time step as fillSampleBlock(); only the stateful samples are
+		// evaluated here, the others are left to renderChunk()
+		qsizetype count = 0;
+		while (count < m_chunkSamples && !m_finished)
+		{
+			const bool stateful = isStateful();
+			if (stateful && m_deferring) replayRunEnd();
+			// Every chunk starts its own span; the run may go on from the last one
+			if (!stateful && (!m_deferring || count == 0))
+			{
+				chunk.deferred.push_back({count, 0, m_control});
+				m_run = chunk.deferred.back();
+			}
+			m_deferring = !stateful;
+
+			m_control.sinTime += m_dt;
+			m_control.sawTime += m_dt;
+			if (stateful) chunk.samples[count] = m_kernel(m_control, m_genParam.soundData);
+			else
+			{
+				chunk.deferred.back().sampleCount++;
+				m_run.sampleCount++;
+			}
+			count++;
+			m_finished = !m_genParam.masconData.checkForFreqChange(m_control, m_genParam.soundData, m_dt);
+		}
+
+		chunk.sampleCount = count;
+		chunk.samples.resize(count);
+		m_nextSample += count;
+		return true;
+	}
+
+	void renderChunk(
+		Chunk &chunk,
+		const GenerationCommon::GenerationBasicParameter &genParam,
+		double dt,
+		SampleKernel kernel
+	)
+	{
+		for (const DeferredSpan &span : chunk.deferred)
+		{
+			VvvfValues control = span.control;
+			for (float &sample : std::span<float>(chunk.samples).subspan(span.offset, span.sampleCount))
+			{
+				control.sinTime += dt;
+				control.sawTime += dt;
+				sample = kernel(control, genParam.soundData);
+				genParam.masconData.checkForFreqChange(control, genParam.soundData, dt);
+			}
+		}
+	}
+
+	qsizetype render(
+		GenerationCommon::GenerationBasicParameter &genParam,
+		double dt,
+		SampleKernel kernel,
+		const SampleSink &sink,
+		const Options &options
+	)
+	{
+		const qsizetype chunkSamples = std::max<qsizetype>(options.chunkSamples, 1);
+		qsizetype total = 0;
+
+		if (!isChunkable(genParam.soundData))
+		{
+			VvvfValues control{};
+			std::vector<float> block(chunkSamples);
+			bool finished = false;
+			while (!finished)
+			{
+				const qsizetype count = VvvfSound::Audio::fillSampleBlock(control, genParam, dt, block, finished, kernel);
+				sink(std::span<const float>(block.data(), count));
+				total += count;
+			}
+			return total;
+		}
+
+		const qsizetype waveSize = options.chunksPerWave > 0
+			? options.chunksPerWave
+			: std::max(1, QThreadPool::globalInstance()->maxThreadCount() * 2);
+
+		ChunkPlanner planner(genParam, VvvfValues{}, dt, chunkSamples, kernel);
+		const auto planWave = [&planner, waveSize](std::vector<Chunk> &wave)
+		{
+			// Keeps the sample buffers of the previous use of this wave
+			wave.resize(waveSize);
+			qsizetype planned = 0;
+			while (planned < waveSize && planner.next(wave[planned])) planned++;
+			wave.resize(planned);
+		};
+
+		// Serial reference for Options::crossCheck, stepped like fillSampleBlock()
+		VvvfValues reference{};
+		bool referenceFinished = false;
+		std::vector<float> expected;
+		const auto renderReference = [&](const std::vector<Chunk> &wave)
+		{
+			qsizetype count = 0;
+			for (const Chunk &chunk : wave) count += chunk.sampleCount;
+			expected.resize(count);
+			qsizetype written = 0;
+			for (; written < count && !referenceFinished; written++)
+			{
+				reference.sinTime += dt;
+				reference.sawTime += dt;
+				expected[written] = kernel(reference, genParam.soundData);
+				referenceFinished = !genParam.masconData.checkForFreqChange(reference, genParam.soundData, dt);
+			}
+			expected.resize(written);
+		};
+
+		std::vector<Chunk> current, next;
+		planWave(current);
+		while (!current.empty())
+		{
+			QFuture<void> running = QtConcurrent::map(current, [&genParam, dt, kernel](Chunk &chunk)
+			{
+				renderChunk(chunk, genParam, dt, kernel);
+			});
+
+			// The planner is serial, so run it while the pool renders
+			if (genParam.progress.cancel) next.clear();
+			else planWave(next);
+			if (options.crossCheck) renderReference(current);
+			running.waitForFinished();
+
+			qsizetype offset = 0;
+			for (const Chunk &chunk : current)
+			{
+				if (options.crossCheck)
+				{
+					const bool matches = offset + chunk.sampleCount <= qsizetype(expected.size())
+						&& memcmp(chunk.samples.data(), expected.data() + offset, chunk.sampleCount * sizeof(float)) == 0;
+					if (!matches)
+						qWarning().nospace() << "ParallelRender: chunk at sample " << chunk.firstSample << " differs from the serial render";
+					offset += chunk.sampleCount;
+				}
+
+				sink(chunk.samples);
+				total += chunk.sampleCount;
+				genParam.progress.progress += chunk.sampleCount;
+			}
+			if (genParam.progress.cancel) break;
+			std::swap(current, next);
+		}
+		return total;
+	}
+}
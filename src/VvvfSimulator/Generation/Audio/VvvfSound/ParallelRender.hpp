@@ -0,0 +1,200 @@
+#pragma once
+
+// Standard Library
+#include <array>
+#include <functional>
+#include <span>
+#include <vector>
+// Packages
+#include <QtGlobal>
+// Internal
+#include "../../GenerateCommon.hpp"
+#include "../../../Vvvf/Struct.hpp"
+
+namespace VvvfSimulator::Generation::Audio::VvvfSound::ParallelRender
+{
+	/*
+	@brief Per-sample generator. For patterns without carried state (see
+	carriesState()) it must only depend on the time and control parts of the
+	given state, so that a span started from a snapshot produces exactly the
+	samples the serial render would have produced at that point. Whatever it
+	writes back into the state for such patterns must only depend on them as
+	well, so evaluating the last sample of a run is enough to reproduce what
+	the whole run left behind.
+	*/
+	using SampleKernel = float (*)(
+		NAMESPACE_VVVF::Struct::VvvfValues &,
+		const NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData &
+	);
+
+	/*
+	@brief Receives the rendered samples, in timeline order. Called from the
+	thread that called render().
+	*/
+	using SampleSink = std::function<void(std::span<const float>)>;
+
+	struct Options
+	{
+		/// Samples per chunk, i.e. per task handed to the thread pool
+		qsizetype chunkSamples = 1 << 16;
+		/// Chunks in flight at once; 0 picks twice the global pool size
+		int chunksPerWave = 0;
+		/// Also render every wave serially (see fillSampleBlock()) and warn
+		/// about each chunk whose samples differ. Defaults to on in debug
+		/// builds.
+#ifdef NDEBUG
+		bool crossCheck = false;
+#else
+		bool crossCheck = true;
+#endif
+	};
+
+	/*
+	@brief A stretch of a chunk left to the pool: where it starts within the
+	chunk, how long it is and the control state right before its first sample.
+	*/
+	struct DeferredSpan
+	{
+		qsizetype offset = 0;
+		qsizetype sampleCount = 0;
+		NAMESPACE_VVVF::Struct::VvvfValues control{};
+	};
+
+	/*
+	@brief A chunk of the timeline. The samples of stateful regions (see
+	carriesState()) are already in samples when the planner hands the chunk
+	out; the deferred spans are filled in by renderChunk().
+	*/
+	struct Chunk
+	{
+		qsizetype firstSample = 0;
+		qsizetype sampleCount = 0;
+		std::vector<DeferredSpan> deferred;
+		std::vector<float> samples;
+	};
+
+	/*
+	@brief Whether evaluating a sample of the given pattern advances state the
+	following samples depend on.
+
+	Asynchronous patterns do: the carrier time and frequency, the random
+	carrier draw (VvvfValues::rnd and the previous draw/time) and the periodic
+	carrier time are all advanced while the sample is evaluated, so they can
+	only be reproduced by evaluating every sample in order. Synchronous
+	patterns only depend on the sine phase, control frequency and mascon
+	flags, which the time step and the mascon timeline reproduce on their own.
+	The v1.9.1.1 format has no delta-sigma mode; one would carry its
+	integrator state and belong here as well.
+	*/
+	bool carriesState(const NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData::YamlControlData &data);
+
+	/*
+	@brief Whether any part of a sound can be rendered in independent chunks,
+	i.e. whether any of its patterns is free of carried state.
+	*/
+	bool isChunkable(const NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData &soundData);
+
+	/*
+	@brief Walks the mascon timeline serially and cuts it into chunks.
+
+	Every sample gets the time step and
+	GenerationBasicParameter::masconData.checkForFreqChange(). Samples of
+	stateful patterns are also evaluated with the kernel right away, which
+	keeps the carried state exact; runs of the other samples are deferred to
+	renderChunk() together with the state snapshot they start from. When a
+	deferred run is followed by a stateful sample, the run's last sample is
+	replayed with the kernel on a scratch copy first, so the stateful samples
+	continue from what the kernel left in the state, as in the serial render.
+	A sound that starts asynchronous thus renders its start serially in the
+	planner (which overlaps with the previous wave) and the synchronous rest
+	in parallel.
+
+	The pattern search only covers the patterns up to the last stateful one
+	of each list (a later first match is stateless either way) and is skipped
+	while its inputs stay the same.
+	*/
+	class ChunkPlanner
+	{
+		/// Inputs of YamlVvvfWave::isMatching() and the answer for them
+		struct Lookup
+		{
+			double controlFrequency = 0.0;
+			double sinAngleFreq = 0.0;
+			bool brake = false;
+			bool masconOff = false;
+			bool freeRun = false;
+			bool stateful = false;
+		};
+
+		const GenerationCommon::GenerationBasicParameter &m_genParam;
+		NAMESPACE_VVVF::Struct::VvvfValues m_control;
+		double m_dt;
+		qsizetype m_chunkSamples;
+		SampleKernel m_kernel;
+		qsizetype m_nextSample = 0;
+		bool m_finished = false;
+
+		/// Indexed by VvvfValues::brake: patterns past this one can't make a
+		/// sample stateful
+		std::array<size_t, 2> m_searchEnd{};
+		/// Indexed by VvvfValues::brake: every pattern is stateful
+		std::array<bool, 2> m_allStateful{};
+		Lookup m_lookup;
+		bool m_lookupValid = false;
+
+		/// The deferred run in progress, possibly started in an earlier chunk
+		bool m_deferring = false;
+		DeferredSpan m_run;
+
+		bool isStateful();
+		void replayRunEnd();
+
+	public:
+		ChunkPlanner(
+			const GenerationCommon::GenerationBasicParameter &genParam,
+			const NAMESPACE_VVVF::Struct::VvvfValues &initial,
+			double dt,
+			qsizetype chunkSamples,
+			SampleKernel kernel
+		);
+
+		/*
+		@returns False once the timeline has been fully planned, in which case
+		chunk is left untouched. Reuses the buffers already held by chunk.
+		*/
+		bool next(Chunk &chunk);
+		constexpr bool finished() const noexcept { return m_finished; }
+		constexpr qsizetype plannedSamples() const noexcept { return m_nextSample; }
+	};
+
+	/*
+	@brief Renders the deferred spans of one planned chunk into chunk.samples,
+	stepping exactly like fillSampleBlock() does.
+	*/
+	void renderChunk(
+		Chunk &chunk,
+		const GenerationCommon::GenerationBasicParameter &genParam,
+		double dt,
+		SampleKernel kernel
+	);
+
+	/*
+	@brief Renders the whole mascon timeline, in parallel chunks on the global
+	thread pool when isChunkable() allows it and serially otherwise. The
+	output is bit-identical either way, which Options::crossCheck verifies.
+
+	Chunks are rendered in waves of Options::chunksPerWave; the next wave is
+	planned while the current one renders and each finished wave is handed to
+	sink in order, so memory use stays bounded by the wave size.
+
+	@returns How many samples were rendered. Stops early (between waves) if
+	genParam.progress.cancel is set.
+	*/
+	qsizetype render(
+		GenerationCommon::GenerationBasicParameter &genParam,
+		double dt,
+		SampleKernel kernel,
+		const SampleSink &sink,
+		const Options &options = {}
+	);
+}
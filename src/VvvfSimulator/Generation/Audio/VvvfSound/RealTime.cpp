@@ -1,13 +1,18 @@
 #include "RealTime.hpp"
 
+// Standard Library
+#include <algorithm>
+#include <chrono>
+#include <vector>
 // Packages
+#include <QAudioFormat>
 #include <QAudioSink>
 #include <QByteArray>
 #include <QFuture>
 #include <QScopedPointer>
 #include <QtConcurrent/QtConcurrent>
 // Internal
-#include "../BufferedWaveIODevice.hpp"
+#include "../RingWaveIODevice.hpp"
 #include "../../../Outcome.hpp"
 #include "../../../Vvvf/Calculate.hpp"
 #include "../../../Vvvf/Struct.hpp"
@@ -24,9 +29,15 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::RealTime
 {
 	namespace
 	{
+		/// RealTime_VVVF_BuffSize is in bytes (of float samples), the ring counts samples
+		size_t bufferSizeInSamples()
+		{
+			return size_t(std::max(Properties::Settings::Default::RealTime_VVVF_BuffSize, 0)) / sizeof(float);
+		}
+
 		inline Outcome::Result<void, std::variant<QSerialPort::SerialPortError, std::exception_ptr>> generate
 		(
-			BufferedWaveIODevice &provider,
+			RingWaveIODevice &provider,
 			const Yaml::VvvfSound::YamlVvvfSoundData &soundData,
 			Vvvf::Struct::VvvfValues &control,
 			GenerateRealTimeCommon::RealTimeParameter &param,
@@ -37,6 +48,7 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::RealTime
 				return serial.error();
 
 			int endResult;
+			std::vector<float> samples;
 			while (true)
 			{
 				const int &calcCount = Properties::Settings::Default::RealtimeVvvfCalculateDivision;
@@ -47,6 +59,7 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::RealTime
 
 				QByteArray data;
 				data.reserve(calcCount);
+				samples.resize(calcCount);
 
 				for (int i = 0; i < calcCount; i++)
 				{
@@ -58,14 +71,9 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::RealTime
 					Vvvf::Struct::WaveValues value = Vvvf::Calculate::calculatePhases(control, calculated_Values, 0.0);
 					data.push_back(value.U << 4 | value.V << 2 | value.W);
 
-					const float soundByte = (value.U - value.V) * 0.35;
-
-					provider.addSample(QByteArray
-					(
-						reinterpret_cast<const char *const>(&soundByte),
-						sizeof(soundByte) / sizeof(char)
-					));
+					samples[i] = (value.U - value.V) * 0.35f;
 				}
+				provider.addSamples(samples);
 
 				static QFuture<qint64> lastWrite;
 				if (lastWrite.isRunning())
@@ -80,7 +88,11 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::RealTime
 					return serial.write(data);
 				});
 
-				while (provider.bufferedBytes() + calcCount > Properties::Settings::Default::RealTime_VVVF_BuffSize);
+				// Sleep until the sink drained enough to take the next block.
+				// requestQuit() wakes the wait; the timeout is only a fallback.
+				const size_t bufferSize = bufferSizeInSamples();
+				const size_t level = bufferSize > size_t(calcCount) ? bufferSize - calcCount : 0;
+				while (!param.quit && !provider.waitForBufferedAtMost(level, std::chrono::milliseconds(100)));
 			}
 
 			constexpr char trailer = 0xFF;
@@ -112,11 +124,21 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::RealTime
 
 		param.control = Vvvf::Struct::VvvfValues();
 
-		QScopedPointer<BufferedWaveIODevice> provider(new BufferedWaveIODevice());
-		// provider.setDiscardOnBufferOverflow(true);
-		QAudioSink aSink(*(param.audioDevice), QAudioFormat::Float);
+		QAudioFormat format;
+		format.setSampleRate(Properties::Settings::Default::RealtimeVvvfSamplingFrequency);
+		format.setChannelCount(1);
+		format.setSampleFormat(QAudioFormat::Float);
+
+		// Leave room for one more calculation block on top of the target fill
+		// level, so the generator never has to drop samples.
+		QScopedPointer<RingWaveIODevice> provider(new RingWaveIODevice(
+			format,
+			bufferSizeInSamples() + Properties::Settings::Default::RealtimeVvvfCalculateDivision
+		));
+		QAudioSink aSink(*(param.audioDevice), format);
 
 		aSink.start(provider.get());
+		param.setProvider(provider.get());
 
 		Outcome::Result<void, std::variant<QSerialPort::SerialPortError, std::exception_ptr>> stat;
 		try
@@ -129,6 +151,7 @@ namespace VvvfSimulator::Generation::Audio::VvvfSound::RealTime
 		}
 		finally
 		{
+			param.setProvider(nullptr);
 			aSink.stop();
 		}
 
@@ -0,0 +1,346 @@
+#include "BatchRender.hpp"
+
+// Copyright © 2025 VvvfGeeks, VVVF Systems
+// SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later OR GPL-3.0-or-later
+
+// BatchRender.cpp
+// Version 1.9.1.1
+
+// Standard Library
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <functional>
+// Packages
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QGuiApplication>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+#include <QtDebug>
+#include <rfl/json.hpp>
+#include <rfl/yaml.hpp>
+// Internal
+#include "Audio/VvvfSound/Audio.hpp"
+#include "Video/FramePipeline.hpp"
+#include "Video/ControlInfo/GenerateControlOriginal.hpp"
+#include "Video/FFT/GenerateFFT.hpp"
+#include "Video/Hexagon/GenerateHexagonOriginal.hpp"
+
+namespace VvvfSimulator::Generation::BatchRender
+{
+	using GenerationCommon::YamlVvvfSoundData;
+	using NAMESPACE_YAMLMASCONCONTROL::YamlMasconAnalyze::YamlMasconData;
+	using Yaml::RflCppFormats;
+
+	namespace
+	{
+		using Video::FramePipeline;
+
+		/*
+		Writes count frames of a planned timeline through its own frame pipeline,
+		framesInFlight of them rendering at once. Blank frames (one second each)
+		go before and after when asked for, like the FFT exporter's waits.
+		*/
+		void renderVideo(
+			const std::filesystem::path &path,
+			const QSize &size,
+			double fps,
+			int framesInFlight,
+			bool blankWaits,
+			bool darkMode,
+			qsizetype count,
+			const std::function<FramePipeline::RenderJob(qsizetype)> &frameAt)
+		{
+			GenerationCommon::GenerationVideoWriter vr(path, size.width(), size.height(), fps, AV_CODEC_ID_H264);
+			vr.setQueueCapacity(GenerationCommon::GenerationVideoWriter::defaultQueueCapacity);
+			vr.open();
+
+			const size_t waitFrames = static_cast<size_t>(std::lround(fps));
+			if (blankWaits) vr.addEmptyFrames(waitFrames, darkMode);
+
+			FramePipeline::Options pipelineOptions;
+			pipelineOptions.headless = true;
+			pipelineOptions.framesInFlight = framesInFlight;
+			FramePipeline pipeline([&vr](const QImage &frame) { vr.writeFrame(frame); }, pipelineOptions);
+			qsizetype next = 0;
+			pipeline.run([&](FramePipeline::RenderJob &job)
+			{
+				if (next >= count) return false;
+				job = frameAt(next++);
+				return true;
+			});
+
+			if (blankWaits) vr.addEmptyFrames(waitFrames, darkMode);
+			vr.close();
+		}
+
+		QString kindName(OutputKind kind)
+		{
+			switch (kind)
+			{
+			case OutputKind::Wav: return QStringLiteral("wav");
+			case OutputKind::FFTVideo: return QStringLiteral("fft");
+			case OutputKind::HexagonVideo: return QStringLiteral("hexagon");
+			default: return QStringLiteral("control"); // OutputKind::ControlInfoVideo
+			}
+		}
+
+		YamlMasconData loadMascon(const std::filesystem::path &path)
+		{
+			const bool isJson = path.extension() == ".json";
+			auto result = isJson ? rfl::json::load<YamlMasconData>(path.string()) : rfl::yaml::load<YamlMasconData>(path.string());
+			return result.value(); // Throws std::runtime_error on failure
+		}
+	}
+
+	Options::Options()
+	{
+		titleFont.setPointSizeF(40.0);
+		titleFont.setBold(true);
+		valueFont.setPointSizeF(60.0);
+		valueMiniFont.setPointSizeF(22.0);
+	}
+
+	std::optional<Output> parseOutput(const QString &specification)
+	{
+		const qsizetype separator = specification.indexOf(u':');
+		// Anything shorter is a Windows drive letter, not a kind
+		if (separator < 2) return std::nullopt;
+
+		const QString kind = specification.first(separator).toLower();
+		const std::filesystem::path path(specification.sliced(separator + 1).toStdU16String());
+		if (path.empty()) return std::nullopt;
+
+		for (const OutputKind candidate : { OutputKind::Wav, OutputKind::FFTVideo, OutputKind::HexagonVideo, OutputKind::ControlInfoVideo })
+			if (kind == kindName(candidate)) return Output{ candidate, path };
+		return std::nullopt;
+	}
+
+	QVector<VvvfValues> planFrames(const GenerationBasicParameter &parameter, double fps)
+	{
+		QVector<VvvfValues> frames;
+		frames.reserve(static_cast<qsizetype>(parameter.masconData.getEstimatedSteps(1.0 / fps)) + 1);
+
+		VvvfValues control;
+		control.allowRandomFreqMove = false;
+		do
+		{
+			VvvfValues &frame = frames.emplace_back(control);
+			frame.sinTime = 0.0;
+			frame.sawTime = 0.0;
+		}
+		while (!parameter.progress.cancel && parameter.masconData.checkForFreqChange(control, parameter.soundData, 1.0 / fps));
+		return frames;
+	}
+
+	int render(GenerationBasicParameter &parameter, const QList<Output> &outputs, const Options &options)
+	{
+		const auto isVideo = [](const Output &output) { return output.kind != OutputKind::Wav; };
+		const qsizetype videoCount = std::count_if(outputs.begin(), outputs.end(), isVideo);
+
+		// One pass over the mascon timeline for every video
+		const QVector<VvvfValues> frames = videoCount > 0 ? planFrames(parameter, options.fps) : QVector<VvvfValues>();
+		const qsizetype frameCount = frames.size();
+		// The global pool renders frames (and audio chunks), split between the videos
+		const int framesInFlight = std::max(2, QThreadPool::globalInstance()->maxThreadCount() / int(std::max<qsizetype>(videoCount, 1)));
+
+		const YamlVvvfSoundData &sound = parameter.soundData;
+		const auto renderOutput = [&](const Output &output)
+		{
+			switch (output.kind)
+			{
+			case OutputKind::Wav:
+				Audio::VvvfSound::Audio::exportWavLine(parameter, options.samplingFrequency, false, output.path);
+				break;
+			case OutputKind::FFTVideo:
+				renderVideo(output.path, options.fftSize, options.fps, framesInFlight, true, options.darkMode, frameCount,
+					[&](qsizetype i) -> FramePipeline::RenderJob
+					{
+						return [&frames, &sound, &options, i]() { return Video::FFT::GenerateFFT::getImage(frames[i], sound, options.fftSize, options.darkMode); };
+					});
+				break;
+			case OutputKind::HexagonVideo:
+				renderVideo(output.path, options.hexagonSize, options.fps, framesInFlight, true, options.darkMode, frameCount,
+					[&](qsizetype i) -> FramePipeline::RenderJob
+					{
+						return [&frames, &sound, &options, i]()
+						{
+							return Video::ControlInfo::GenerateHexagonOriginal::getImage(
+								frames[i], sound, options.hexagonSize, options.hexagonDelta, options.hexagonThickness,
+								options.hexagonZeroVectorCircle, true, options.darkMode);
+						};
+					});
+				break;
+			case OutputKind::ControlInfoVideo:
+			{
+				// Like the exporter: a second on the first state, the run, then a
+				// second of the final screen
+				const qsizetype holdFrames = std::lround(options.fps);
+				const QSize &size = options.controlInfoSize;
+				renderVideo(output.path, size, options.fps, framesInFlight, false, options.darkMode, holdFrames + frameCount + holdFrames,
+					[&](qsizetype i) -> FramePipeline::RenderJob
+					{
+						const qsizetype frame = std::clamp<qsizetype>(i - holdFrames, 0, frameCount - 1);
+						const bool finalShow = i >= holdFrames + frameCount;
+						return [&frames, &options, &size, frame, finalShow]()
+						{
+							return Video::ControlInfo::GenerateControlOriginal::getImage(
+								frames[frame], finalShow, size.width(), size.height(),
+								options.titleFont, options.valueFont, options.valueMiniFont, options.darkMode);
+						};
+					});
+				break;
+			}
+			}
+		};
+
+		// The outputs' own drivers block on the global pool, so they get a pool of their own
+		QThreadPool drivers;
+		drivers.setMaxThreadCount(int(std::max<qsizetype>(outputs.size(), 1)));
+		QList<QFuture<bool>> futures;
+		for (const Output &output : outputs)
+		{
+			futures.append(QtConcurrent::run(&drivers, [&renderOutput, output]()
+			{
+				QElapsedTimer timer;
+				timer.start();
+				try
+				{
+					renderOutput(output);
+				}
+				catch (const std::exception &e)
+				{
+					qWarning().noquote() << QObject::tr("Batch render: %1 output %2 failed: %3")
+						.arg(kindName(output.kind), QString::fromStdU16String(output.path.u16string()), QString::fromUtf8(e.what()));
+					return false;
+				}
+				qInfo().noquote() << QObject::tr("Batch render: %1 output %2 done in %3 s")
+					.arg(kindName(output.kind), QString::fromStdU16String(output.path.u16string()))
+					.arg(timer.elapsed() / 1000.0);
+				return true;
+			}));
+		}
+
+		int failures = 0;
+		for (QFuture<bool> &future : futures)
+			if (!future.result()) failures++;
+		return failures;
+	}
+
+	bool runBenchmark(const QString &name, const GenerationBasicParameter &parameter, const Options &options, qsizetype samples)
+	{
+		if (name == QStringLiteral("line-sample"))
+			Audio::VvvfSound::Audio::Benchmark::measureLineSampleThroughput(parameter, options.samplingFrequency, samples);
+		else return false;
+		return true;
+	}
+
+	bool isRequested(int argc, char *argv[])
+	{
+		for (int i = 1; i < argc; i++)
+			if (std::strcmp(argv[i], "--batch") == 0) return true;
+		return false;
+	}
+
+	int exec(int &argc, char *argv[])
+	{
+		if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+		QGuiApplication app(argc, argv);
+		app.setOrganizationName(QStringLiteral("VVVF Systems"));
+		app.setOrganizationDomain(QStringLiteral("vvvfgeeks.org"));
+		app.setApplicationName(QStringLiteral("VVVF-Simulator-Q"));
+		app.setApplicationVersion(QStringLiteral("1.9.1.1"));
+		return run(app);
+	}
+
+	int run(QCoreApplication &app)
+	{
+		QCommandLineParser parser;
+		parser.setApplicationDescription(QObject::tr("Renders audio and videos of a VVVF sound without the GUI."));
+		parser.addHelpOption();
+		const QCommandLineOption batchOption(QStringLiteral("batch"), QObject::tr("Run a headless batch render."));
+		const QCommandLineOption soundOption(QStringLiteral("sound"), QObject::tr("VVVF sound file (YAML or JSON)."), QObject::tr("file"));
+		const QCommandLineOption masconOption(QStringLiteral("mascon"), QObject::tr("Mascon file (YAML or JSON)."), QObject::tr("file"));
+		const QCommandLineOption outputOption(QStringList{ QStringLiteral("o"), QStringLiteral("output") },
+			QObject::tr("Output as kind:path, kind being wav, fft, hexagon or control. Repeatable."), QObject::tr("kind:path"));
+		const QCommandLineOption fpsOption(QStringLiteral("fps"), QObject::tr("Video frame rate."), QObject::tr("fps"), QStringLiteral("60"));
+		const QCommandLineOption samplingOption(QStringLiteral("sampling-rate"), QObject::tr("Audio sampling rate in Hz."), QObject::tr("Hz"), QStringLiteral("192000"));
+		const QCommandLineOption darkOption(QStringLiteral("dark"), QObject::tr("Dark mode videos."));
+		const QCommandLineOption benchmarkOption(QStringLiteral("benchmark"),
+			QObject::tr("Measure a generation path on the input files before rendering: line-sample. Repeatable."), QObject::tr("name"));
+		const QCommandLineOption benchmarkSamplesOption(QStringLiteral("benchmark-samples"),
+			QObject::tr("Samples generated per measured path."), QObject::tr("count"), QStringLiteral("1000000"));
+		parser.addOptions({ batchOption, soundOption, masconOption, outputOption, fpsOption, samplingOption, darkOption, benchmarkOption, benchmarkSamplesOption });
+		parser.process(app);
+
+		if (!parser.isSet(soundOption) || !parser.isSet(masconOption) || (!parser.isSet(outputOption) && !parser.isSet(benchmarkOption)))
+		{
+			qCritical().noquote() << QObject::tr("Batch render needs --sound, --mascon and at least one --output or --benchmark.");
+			return 2;
+		}
+
+		Options options;
+		bool ok = false;
+		options.fps = parser.value(fpsOption).toDouble(&ok);
+		if (!ok || options.fps <= 0.0)
+		{
+			qCritical().noquote() << QObject::tr("Invalid frame rate: %1").arg(parser.value(fpsOption));
+			return 2;
+		}
+		options.samplingFrequency = parser.value(samplingOption).toInt(&ok);
+		if (!ok || options.samplingFrequency <= 0)
+		{
+			qCritical().noquote() << QObject::tr("Invalid sampling rate: %1").arg(parser.value(samplingOption));
+			return 2;
+		}
+		options.darkMode = parser.isSet(darkOption);
+		const qsizetype benchmarkSamples = parser.value(benchmarkSamplesOption).toLongLong(&ok);
+		if (!ok || benchmarkSamples <= 0)
+		{
+			qCritical().noquote() << QObject::tr("Invalid benchmark sample count: %1").arg(parser.value(benchmarkSamplesOption));
+			return 2;
+		}
+
+		QList<Output> outputs;
+		for (const QString &specification : parser.values(outputOption))
+		{
+			const std::optional<Output> output = parseOutput(specification);
+			if (!output)
+			{
+				qCritical().noquote() << QObject::tr("Invalid output: %1").arg(specification);
+				return 2;
+			}
+			outputs.append(*output);
+		}
+
+		GenerationBasicParameter parameter;
+		try
+		{
+			const std::filesystem::path soundPath(parser.value(soundOption).toStdU16String());
+			const std::filesystem::path masconPath(parser.value(masconOption).toStdU16String());
+			parameter.soundData = YamlVvvfSoundData(soundPath.extension() == ".json" ? RflCppFormats::JSON : RflCppFormats::YAML, soundPath);
+			parameter.masconData = GenerationCommon::YamlMasconDataCompiled(loadMascon(masconPath).sort());
+		}
+		catch (const std::exception &e)
+		{
+			qCritical().noquote() << QObject::tr("Could not load the input files: %1").arg(QString::fromUtf8(e.what()));
+			return 2;
+		}
+
+		for (const QString &name : parser.values(benchmarkOption))
+		{
+			if (!runBenchmark(name, parameter, options, benchmarkSamples))
+			{
+				qCritical().noquote() << QObject::tr("Unknown benchmark: %1").arg(name);
+				return 2;
+			}
+		}
+
+		return outputs.isEmpty() || render(parameter, outputs, options) == 0 ? 0 : 1;
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+// Copyright © 2025 VvvfGeeks, VVVF Systems
+// SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later OR GPL-3.0-or-later
+
+// BatchRender.hpp
+// Version 1.9.1.1
+
+// Standard Library
+#include <filesystem>
+#include <optional>
+// Packages
+#include <QCoreApplication>
+#include <QFont>
+#include <QList>
+#include <QSize>
+#include <QString>
+#include <QVector>
+// Internal
+#include "BatchRenderEntry.hpp"
+#include "GenerateCommon.hpp"
+#include "../Vvvf/Struct.hpp"
+
+namespace VvvfSimulator::Generation::BatchRender
+{
+	using GenerationCommon::GenerationBasicParameter;
+	using NAMESPACE_VVVF::Struct::VvvfValues;
+
+	enum class OutputKind
+	{
+		Wav,              // Line voltage audio
+		FFTVideo,
+		HexagonVideo,
+		ControlInfoVideo
+	};
+
+	struct Output
+	{
+		OutputKind kind;
+		std::filesystem::path path;
+	};
+
+	struct Options
+	{
+		double fps = 60.0;
+		int samplingFrequency = 192000;
+		bool darkMode = false;
+		QSize fftSize = QSize(1000, 1000);
+		QSize hexagonSize = QSize(1000, 1000);
+		QSize controlInfoSize = QSize(500, 1080);
+		int hexagonDelta = 4096;
+		qreal hexagonThickness = 2.0;
+		bool hexagonZeroVectorCircle = true;
+		QFont titleFont, valueFont, valueMiniFont;
+
+		Options();
+	};
+
+	/*
+	@brief Parses an output given as "kind:path", kind being one of wav, fft,
+	hexagon or control.
+	*/
+	std::optional<Output> parseOutput(const QString &specification);
+
+	/*
+	@brief The shared modulation pass: walks the mascon timeline once at the
+	video frame rate and keeps the control state of every frame, as the video
+	exporters see it (no random frequency moves, sine and carrier time reset).
+	*/
+	QVector<VvvfValues> planFrames(const GenerationBasicParameter &parameter, double fps);
+
+	/*
+	@brief Renders every output at once: the videos from one planFrames()
+	timeline, the audio through the parallel chunk renderer. Outputs are
+	independent, a failing one is reported and doesn't stop the others.
+
+	@returns How many outputs failed.
+	*/
+	int render(GenerationBasicParameter &parameter, const QList<Output> &outputs, const Options &options = Options());
+
+	/*
+	@brief Runs the named --benchmark on the loaded files and logs the result:
+	line-sample (per-sample vs. block line voltage generation).
+
+	@returns False if name is not a known benchmark.
+	@param samples Upper bound of samples generated per measured path.
+	*/
+	bool runBenchmark(const QString &name, const GenerationBasicParameter &parameter, const Options &options, qsizetype samples);
+
+	/*
+	@brief Parses the command line of app, loads the sound and mascon files and
+	renders; see exec() for the whole --batch mode.
+
+	@returns The process exit code.
+	*/
+	int run(QCoreApplication &app);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+// Copyright © 2025 VvvfGeeks, VVVF Systems
+// SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later OR GPL-3.0-or-later
+
+// BatchRenderEntry.hpp
+// Version 1.9.1.1
+
+// Entry points of the headless batch render, kept apart from BatchRender.hpp
+// so that main.cpp doesn't pull in the generation and legacy headers.
+// main.cpp only calls them when built with VVVF_BATCH_RENDER (the CMake option
+// of the same name), which adds BatchRender.cpp and the generation sources it
+// renders with to the target.
+
+namespace VvvfSimulator::Generation::BatchRender
+{
+	/// Whether the command line asks for a batch render (--batch)
+	bool isRequested(int argc, char *argv[]);
+
+	/*
+	@brief Runs a batch render for the whole process: starts a QGuiApplication
+	on the offscreen platform (unless QT_QPA_PLATFORM says otherwise, fonts and
+	QPainter still need one), parses the command line, loads the sound and
+	mascon files and renders. No QML engine, no windows, no instance check.
+
+	@returns The process exit code.
+	*/
+	int exec(int &argc, char *argv[]);
+}
@@ -1,8 +1,18 @@
 #include "GenerateBasic.hpp"
 // STL Includes
+#include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <cmath>
+#include <complex>
+#include <span>
+#include <vector>
 #include <sstream>
+#include <utility>
+// Internal Includes
+#include "../DSP/Spectral.hpp"
+#include "../Vvvf/InternalMath.hpp"
+#include "../Vvvf/SIMD/PwmSimd.hpp"
 
 namespace VvvfSimulator::Generation
 {
@@ -16,6 +26,191 @@ namespace VvvfSimulator::Generation
 
 		namespace WaveForm
 		{
+			namespace
+			{
+				/// <summary>
+				/// Whether calculatePhases() reduces to a plain two-level sine/triangle
+				/// comparison with constant parameters, which the batched comparator
+				/// evaluates exactly. Random carriers, discrete time, harmonics and
+				/// every other base wave or pulse type take the per-sample path, and
+				/// so do states below the pattern's minimum frequency, where
+				/// calculatePhases() applies that frequency instead.
+				/// </summary>
+				bool isBatchable(const VvvfValues& control, const PwmCalculateValues& value)
+				{
+					using YamlPulseMode = YamlVvvfSoundData::YamlControlData::YamlPulseMode;
+					const bool belowMinimum = control.getSinFreq() < value.minimumFrequency && control.controlFrequency > 0.0;
+					return !value.none && value.level == 2 && !belowMinimum
+						&& value.pulseMode.PulseType == YamlPulseMode::PulseTypeName::ASYNC
+						&& value.pulseMode.BaseWave == YamlPulseMode::BaseWaveType::Sine
+						&& value.pulseMode.PulseHarmonics.empty()
+						&& !value.pulseMode.DiscreteTime.getEnabled()
+						&& value.carrier.range == 0.0;
+				}
+
+				/// <summary>
+				/// Sample count and sampling rate of one cycle, see getUVWCycle().
+				/// </summary>
+				std::pair<qsizetype, double> getCycleSampling(const VvvfValues& control, const YamlVvvfSoundData& sound, qsizetype division, bool precise)
+				{
+					PwmCalculateValues preCalculate = YamlVvvfWave::calculateYaml(control, sound);
+					double _F = control.sinAngleFreq;
+					if (_F < preCalculate.minimumFrequency && control.controlFrequency > 0) _F = preCalculate.minimumFrequency;
+
+					qsizetype count = division;
+					if (precise)
+					{
+						double _K = (_F > 0.01 && _F < 1) ? 1 / _F : 1;
+						count = static_cast<qsizetype>(std::round(division * _K));
+					}
+					return { count, count * _F };
+				}
+
+				/// <summary>
+				/// Batched comparator parameters of a value isBatchable() accepts.
+				/// </summary>
+				Vvvf::Calculate::SIMD::ThreePhaseCompareParameter getCompareParameter(const VvvfValues& control, const PwmCalculateValues& value, double initialPhase)
+				{
+					return {
+						control.sinAngleFreq,
+						InternalMath::m_2PI * value.carrier.baseFrequency,
+						value.amplitude,
+						initialPhase
+					};
+				}
+
+				/// <summary>
+				/// Evaluates samples 0 to count (inclusive) and hands each one to
+				/// emit(index, value) in order, so that the dense and the run-length
+				/// producers share the modulator.
+				/// </summary>
+				template <typename Emit>
+				void generateUVW(VvvfValues& control, PwmCalculateValues& calculated_Values, double initialPhase, double invDeltaT, qsizetype count, Emit&& emit)
+				{
+					const qsizetype samples = count + 1;
+
+					if (isBatchable(control, calculated_Values))
+					{
+						const auto param = getCompareParameter(control, calculated_Values, initialPhase);
+						constexpr qsizetype blockSize = 1024;
+						std::array<double, blockSize> time;
+						std::array<int_fast8_t, blockSize> U, V, W;
+						for (qsizetype begin = 0; begin < samples; begin += blockSize)
+						{
+							const qsizetype size = std::min(blockSize, samples - begin);
+							for (qsizetype i = 0; i < size; i++) time[i] = (begin + i) / invDeltaT;
+							Vvvf::Calculate::SIMD::threePhaseCompare(
+								param,
+								std::span<const double>(time.data(), size),
+								std::span(U.data(), size), std::span(V.data(), size), std::span(W.data(), size)
+							);
+							for (qsizetype i = 0; i < size; i++) emit(begin + i, WaveValues(U[i], V[i], W[i]));
+						}
+						return;
+					}
+
+					for (qsizetype i = 0; i < samples; i++)
+					{
+						double parameterSet = i / invDeltaT;
+						control.generationCurrentTime = parameterSet;
+						control.sineTime = parameterSet;
+						control.sawTime = parameterSet;
+						emit(i, Calculate::calculatePhases(control, calculated_Values, initialPhase));
+					}
+				}
+
+				/// <summary>
+				/// Exact switching instants of the batched comparator over samples 0
+				/// to count. The carrier is a straight line between two of its
+				/// vertices, and the reference barely bends over 1/64 of its cycle,
+				/// so each such interval holds at most one crossing per phase: a sign
+				/// change brackets it, Newton refines it from the regula falsi guess
+				/// and bisection takes over whenever Newton leaves the bracket.
+				/// </summary>
+				void solveUVWEdges(const Vvvf::Calculate::SIMD::ThreePhaseCompareParameter& param, double invDeltaT, qsizetype count, EdgeList& list)
+				{
+					using namespace InternalMath;
+					using EquationSolver::BisectionMethod;
+					using EquationSolver::NewtonMethod;
+
+					list.edges.clear();
+					list.sampleCount = count + 1;
+					list.invDeltaT = invDeltaT;
+					list.exactTimes = true;
+					const double duration = count / invDeltaT;
+
+					// Same reference and carrier as threePhaseCompare()
+					const double offsets[3] = { param.initialPhase, param.initialPhase + m_2PI_3, param.initialPhase + m_4PI_3 };
+					const auto difference = [&param](double t, double offset)
+					{
+						return std::clamp(param.amplitude * std::sin(param.sineAngleFrequency * t + offset), -1.0, 1.0)
+							- Functions::triangle(param.carrierAngleFrequency * t);
+					};
+
+					constexpr double tolerance = 1e-12;
+					NewtonMethod newton[3];
+					BisectionMethod bisection[3];
+					std::array<double, 3> previous;
+					std::array<int, 3> state;
+					for (int p = 0; p < 3; p++)
+					{
+						const double offset = offsets[p];
+						newton[p].function = bisection[p].function = [difference, offset](double t) { return difference(t, offset); };
+						previous[p] = difference(0.0, offset);
+						state[p] = previous[p] > 0.0 ? 1 : 0;
+					}
+					list.edges.push_back({ 0, WaveValues(state[0], state[1], state[2]), 0.0 });
+					if (!(duration > 0.0)) return;
+
+					// Carrier vertices sit at angles pi / 2 + k pi
+					const double sineStep = param.sineAngleFrequency > 0.0 ? m_2PI / (64.0 * param.sineAngleFrequency) : duration;
+					const auto vertex = [&param](qsizetype k) { return (m_PI_2 + k * m_PI) / param.carrierAngleFrequency; };
+					qsizetype nextVertex = 0;
+					const bool hasVertices = param.carrierAngleFrequency > 0.0;
+
+					std::vector<std::pair<double, int>> crossings;
+					for (double a = 0.0; a < duration;)
+					{
+						double b = std::min(a + sineStep, duration);
+						if (hasVertices)
+						{
+							while (vertex(nextVertex) <= a) nextVertex++;
+							b = std::min(b, vertex(nextVertex));
+						}
+
+						for (int p = 0; p < 3; p++)
+						{
+							const double fa = previous[p], fb = newton[p].function(b);
+							previous[p] = fb;
+							if ((fa > 0.0) == (fb > 0.0)) continue;
+
+							// An exact zero at an end (the clipped reference touching a
+							// carrier vertex) is the crossing itself, and would stall the
+							// bisection, whose bracket test is a strict sign product.
+							double t = fb == 0.0 ? b : a;
+							if (fa != 0.0 && fb != 0.0)
+							{
+								newton[p].dx = (b - a) * 1e-7;
+								t = newton[p](a - fa * (b - a) / (fb - fa), tolerance, 8);
+								if (!(a <= t && t <= b) || std::abs(newton[p].function(t)) >= tolerance)
+									t = bisection[p](a, b, tolerance, 64);
+							}
+							crossings.emplace_back(t, p);
+						}
+						a = b;
+					}
+
+					std::stable_sort(crossings.begin(), crossings.end(), [](const auto& x, const auto& y) { return x.first < y.first; });
+					for (const auto& [time, p] : crossings)
+					{
+						state[p] ^= 1;
+						// The comparison is strict, so the new state shows from the next sample on
+						const qsizetype index = std::min<qsizetype>(static_cast<qsizetype>(std::floor(time * invDeltaT)) + 1, count + 1);
+						list.edges.push_back({ index, WaveValues(state[0], state[1], state[2]), time });
+					}
+				}
+			}
+
 			/// <summary>
 			///  Calculates one cycle of UVW.
 			/// </summary>
@@ -26,24 +221,13 @@ namespace VvvfSimulator::Generation
 			/// <returns> One cycle of UVW </returns>
 			QVector<WaveValues> getUVWCycle(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, qsizetype division, bool precise)
 			{
-				PwmCalculateValues preCalculate = YamlVvvfWave::calculateYaml(control, sound);
-				double _F = control.sinAngleFreq;
-				if (_F < preCalculate.minimumFrequency && control.controlFrequency > 0) _F = preCalculate.minimumFrequency;
-
-				if (precise)
-				{
-					double _K = (_F > 0.01 && _F < 1) ? 1 / _F : 1;
-					count = static_cast<int64_t>(std::round(division * _K));
-				}
-				else
-					count = division;
-				double invDeltaT = count * _F;
+				const auto [count, invDeltaT] = getCycleSampling(control, sound, division, precise);
 				
 				control.generationCurrentTime = 0;
 				control.sinTime = 0;
 				control.sawTime = 0;
 				
-				return getUVW(control, sound, initialPhase, static_cast<double>(invDeltaT), count);
+				return getUVW(control, sound, initialPhase, invDeltaT, count);
 			}
 
 			/// <summary>
@@ -57,17 +241,8 @@ namespace VvvfSimulator::Generation
 			/// <returns> WaveForm of UVW in 1 sec.</returns>
 			QVector<WaveValues> getUVWSec(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, qsizetype division, bool precise)
 			{
-				PwmCalculateValues preCalculate = YamlVvvfWave::calculateYaml(control, sound);
-				double _F = control.sinAngleFreq;
-				if (_F < preCalculate.minimumFrequency && control.controlFrequency > 0) _F = preCalculate.minimumFrequency;
-
-				if (precise)
-				{
-					double _K = (_F > 0.01 && _F < 1) ? 1 / _F : 1;
-					count = static_cast<int64_t>(std::round(division * _K));
-				}
-				else
-					count = division;
+				// Same count as one cycle, spread over a whole second
+				const qsizetype count = getCycleSampling(control, sound, division, precise).first;
 				
 				control.generationCurrentTime = 0;
 				control.sinTime = 0;
@@ -76,20 +251,85 @@ namespace VvvfSimulator::Generation
 				return getUVW(control, sound, initialPhase, static_cast<double>(count), count);
 			}
 
-			QVector<WaveValues> getUVW(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, double invDeltaT, int64_t count)
+			QVector<WaveValues> getUVW(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, double invDeltaT, qsizetype count)
 			{
 				PwmCalculateValues calculated_Values = YamlVvvfWave::calculateYaml(control, sound);
 				QVector<WaveValues> PWM_Array(count + 1);
-				for (qsizetype i = 0; i < PWM_Array.size(); i++)
+				generateUVW(control, calculated_Values, initialPhase, invDeltaT, count, [&PWM_Array](qsizetype i, const WaveValues& value)
 				{
-					double parameterSet = i / invDeltaT;
-					control.generationCurrentTime = parameterSet;
-					control.sineTime = parameterSet;
-					control.sawTime = parameterSet;
-					PWM_Array[i] = Calculate::calculatePhases(control, calculated_Values, initialPhase);
-				}
+					PWM_Array[i] = value;
+				});
 				return PWM_Array;
 			}
+
+			WaveValues EdgeList::at(qsizetype i) const
+			{
+				// Last edge starting at or before i
+				auto edge = std::upper_bound(edges.cbegin(), edges.cend(), i, [](qsizetype index, const Edge& e)
+				{
+					return index < e.index;
+				});
+				if (edge == edges.cbegin()) return WaveValues(0, 0, 0);
+				return std::prev(edge)->state;
+			}
+
+			QVector<WaveValues> EdgeList::toDense() const
+			{
+				QVector<WaveValues> UVW(sampleCount);
+				for (size_t k = 0; k < edges.size(); k++)
+					std::fill_n(UVW.begin() + edges[k].index, runLength(k), edges[k].state);
+				return UVW;
+			}
+
+			EdgeList EdgeList::fromDense(const QVector<WaveValues>& UVW, double invDeltaT)
+			{
+				EdgeList list;
+				list.sampleCount = UVW.size();
+				list.invDeltaT = invDeltaT;
+				for (qsizetype i = 0; i < UVW.size(); i++) list.append(i, UVW.at(i));
+				return list;
+			}
+
+			EdgeList getUVWCycleEdges(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, qsizetype division, bool precise, EdgeSolver solver)
+			{
+				EdgeList list;
+				getUVWCycleEdges(control, sound, initialPhase, division, precise, solver, list);
+				return list;
+			}
+
+			void getUVWCycleEdges(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, qsizetype division, bool precise, EdgeSolver solver, EdgeList& out)
+			{
+				const auto [count, invDeltaT] = getCycleSampling(control, sound, division, precise);
+
+				control.generationCurrentTime = 0;
+				control.sinTime = 0;
+				control.sawTime = 0;
+
+				getUVWEdges(control, sound, initialPhase, invDeltaT, count, solver, out);
+			}
+
+			EdgeList getUVWEdges(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, double invDeltaT, qsizetype count, EdgeSolver solver)
+			{
+				EdgeList list;
+				getUVWEdges(control, sound, initialPhase, invDeltaT, count, solver, list);
+				return list;
+			}
+
+			void getUVWEdges(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, double invDeltaT, qsizetype count, EdgeSolver solver, EdgeList& out)
+			{
+				PwmCalculateValues calculated_Values = YamlVvvfWave::calculateYaml(control, sound);
+				if (solver == EdgeSolver::Analytic && isBatchable(control, calculated_Values))
+					return solveUVWEdges(getCompareParameter(control, calculated_Values, initialPhase), invDeltaT, count, out);
+
+				out.edges.clear();
+				out.sampleCount = count + 1;
+				out.invDeltaT = invDeltaT;
+				out.exactTimes = false;
+				generateUVW(control, calculated_Values, initialPhase, invDeltaT, count, [&out](qsizetype i, const WaveValues& value)
+				{
+					out.append(i, value);
+				});
+			}
 		}
 		
 		namespace Fourier
@@ -135,17 +375,179 @@ namespace VvvfSimulator::Generation
 				}
 				return integral / InternalMath::M_2PI;
 			}
-		}
 
-		QVector<double> getFourierCoefficients(const QVector<WaveValues>& UVW, qsizetype N)
-		{
-			QVector<double> coefficients(N);
-			for (qsizetype n = 1; n <= coefficients.size(); n++)
+			FourierEdges getFourierEdges(const QVector<WaveValues>& UVW)
 			{
-				double result = getFourierFast(UVW, n);
-				coefficients.at(n - 1) = result;
+				FourierEdges edges;
+				edges.period = UVW.size() - 1;
+				if (UVW.size() < 2) return edges;
+
+				// getFourierFast() closes a constant segment at every change, so
+				// each edge weighs (new - previous) level, the start weighs the
+				// first level and the last edge only closes its segment.
+				auto previous = static_cast<int64_t>(UVW.at(0).U - UVW.at(0).V);
+				edges.indices.push_back(0);
+				edges.weights.push_back(static_cast<double>(previous));
+				for (qsizetype i = 1; i < UVW.size(); i++)
+				{
+					const auto level = static_cast<int64_t>(UVW.at(i).U - UVW.at(i).V);
+					if (level == previous) continue;
+					edges.indices.push_back(i);
+					edges.weights.push_back(static_cast<double>(level - previous));
+					previous = level;
+				}
+				if (edges.indices.size() == 1)
+				{
+					// No change at all, so no closed segment either
+					edges.indices.clear();
+					edges.weights.clear();
+					return edges;
+				}
+				edges.weights.back() -= static_cast<double>(previous);
+
+				edges.angles.reserve(edges.indices.size());
+				for (const qsizetype i : edges.indices)
+					edges.angles.push_back(InternalMath::M_2PI * i / edges.period);
+				return edges;
 			}
-			return coefficients;
+
+			FourierEdges getFourierEdges(const WaveForm::EdgeList& UVW)
+			{
+				FourierEdges edges;
+				edges.period = UVW.sampleCount - 1;
+				if (UVW.sampleCount < 2 || UVW.edges.empty()) return edges;
+
+				// Same weighting as the dense overload; events that leave U - V
+				// unchanged are not edges of the line voltage.
+				auto previous = static_cast<int64_t>(UVW.edges.front().state.U - UVW.edges.front().state.V);
+				std::vector<double> times{ 0.0 };
+				edges.indices.push_back(0);
+				edges.weights.push_back(static_cast<double>(previous));
+				for (size_t k = 1; k < UVW.edges.size(); k++)
+				{
+					const auto& edge = UVW.edges[k];
+					const auto level = static_cast<int64_t>(edge.state.U - edge.state.V);
+					if (level == previous) continue;
+					times.push_back(edge.time);
+					edges.indices.push_back(edge.index);
+					edges.weights.push_back(static_cast<double>(level - previous));
+					previous = level;
+				}
+				if (edges.indices.size() == 1)
+				{
+					edges.indices.clear();
+					edges.weights.clear();
+					return edges;
+				}
+
+				edges.angles.reserve(edges.indices.size() + 1);
+				if (UVW.exactTimes)
+				{
+					// Off the sample grid: the angles come from the solved instants.
+					// Unlike getFourierFast(), the last run is closed at the end of
+					// the cycle (2 pi) instead of being dropped, so the sum is the
+					// exact integral of the line voltage.
+					const double angularRate = InternalMath::M_2PI * UVW.invDeltaT / edges.period;
+					for (const double time : times) edges.angles.push_back(angularRate * time);
+					edges.angles.push_back(InternalMath::M_2PI);
+					edges.indices.push_back(edges.period);
+					edges.weights.push_back(-static_cast<double>(previous));
+					edges.period = 0;
+				}
+				else
+				{
+					edges.weights.back() -= static_cast<double>(previous);
+					for (const qsizetype i : edges.indices)
+						edges.angles.push_back(InternalMath::M_2PI * i / edges.period);
+				}
+				return edges;
+			}
+
+			QVector<double> getFourierCoefficientsRecurrence(const FourierEdges& edges, qsizetype N)
+			{
+				QVector<double> coefficients(N, 0.0);
+				const size_t count = edges.angles.size();
+				if (count == 0) return coefficients;
+
+				// cos(n * a) and sin(n * a) per edge, advanced by angle addition;
+				// the loops over edges are independent and vectorize.
+				std::vector<double> c(count), s(count), stepC(count), stepS(count);
+				for (size_t k = 0; k < count; k++)
+				{
+					stepC[k] = c[k] = std::cos(edges.angles[k]);
+					stepS[k] = s[k] = std::sin(edges.angles[k]);
+				}
+
+				// Re-seeding bounds the rounding drift of the recurrence
+				constexpr qsizetype reseedInterval = 256;
+				for (qsizetype n = 1; n <= N; n++)
+				{
+					if (n % reseedInterval == 0)
+						for (size_t k = 0; k < count; k++)
+						{
+							c[k] = std::cos(n * edges.angles[k]);
+							s[k] = std::sin(n * edges.angles[k]);
+						}
+
+					double sum = 0.0;
+					for (size_t k = 0; k < count; k++) sum += edges.weights[k] * c[k];
+					coefficients[n - 1] = sum / (InternalMath::M_2PI * n);
+
+					for (size_t k = 0; k < count; k++)
+					{
+						const double nextC = c[k] * stepC[k] - s[k] * stepS[k];
+						s[k] = s[k] * stepC[k] + c[k] * stepS[k];
+						c[k] = nextC;
+					}
+				}
+				return coefficients;
+			}
+
+			QVector<double> getFourierCoefficientsFFT(const FourierEdges& edges, qsizetype N)
+			{
+				QVector<double> coefficients(N, 0.0);
+				if (edges.indices.empty() || edges.period <= 0) return coefficients;
+
+				// The edges sit on the sample grid (angle 2 pi i / period), so the
+				// whole coefficient series is the real part of one DFT of the
+				// edge weights: sum(w_i * cos(2 pi n i / period)).
+				// The weights are real, so only bins 0 to period / 2 are computed;
+				// the others mirror them (same real part).
+				const qsizetype period = edges.period;
+				std::vector<double> input(period, 0.0);
+				for (size_t k = 0; k < edges.indices.size(); k++)
+					input[edges.indices[k] % period] += edges.weights[k];
+
+				const auto plan = DSP::Spectral::getPlan(period);
+				std::vector<DSP::Spectral::Plan::Complex> output(plan->binCount());
+				plan->transform(input, output);
+				for (qsizetype n = 1; n <= N; n++)
+				{
+					const qsizetype bin = n % period;
+					coefficients[n - 1] = output[std::min(bin, period - bin)].real() / (InternalMath::M_2PI * n);
+				}
+				return coefficients;
+			}
+
+			QVector<double> getFourierCoefficients(const FourierEdges& edges, qsizetype N)
+			{
+				// Recurrence: edges * N multiply-adds. FFT: ~period * log2(period),
+				// with a larger constant; only worth it for long series.
+				const double recurrenceCost = static_cast<double>(edges.angles.size()) * N;
+				const double fftCost = edges.period > 1 ? 8.0 * edges.period * std::log2(static_cast<double>(edges.period)) : 0.0;
+				if (edges.period > 1 && recurrenceCost > fftCost)
+					return getFourierCoefficientsFFT(edges, N);
+				return getFourierCoefficientsRecurrence(edges, N);
+			}
+
+		QVector<double> getFourierCoefficients(const QVector<WaveValues>& UVW, qsizetype N)
+		{
+			return getFourierCoefficients(getFourierEdges(UVW), N);
+		}
+
+		QVector<double> getFourierCoefficients(const WaveForm::EdgeList& UVW, qsizetype N)
+		{
+			return getFourierCoefficients(getFourierEdges(UVW), N);
 		}
 
 		/// <summary>
@@ -159,8 +561,7 @@ namespace VvvfSimulator::Generation
 		QVector<double> getFourierCoefficients(VvvfValues control, const YamlVvvfSoundData& sound, qsizetype delta, qsizetype N)
 		{
 			control.allowRandomFreqMove = false;
-			auto PWM_Array = WaveForm::getUVWCycle(control, sound, InternalMath::M_PI_6, delta, false);
-			return getFourierCoefficients(PWM_Array, N);
+			return getFourierCoefficients(WaveForm::getUVWCycleEdges(control, sound, InternalMath::M_PI_6, delta, false, WaveForm::EdgeSolver::Analytic), N);
 		}
 
 		std::string getDesmosFourierCoefficientsArray(const QVector<double>& coefficients)
@@ -180,16 +581,32 @@ namespace VvvfSimulator::Generation
 		/// <param name="Sound"></param>
 		/// <param name="Control"></param>
 		/// <returns></returns>
-		double getVoltageRate(const VvvfValues& control, const YamlVvvfSoundData& sound, bool precise, bool fixSign = true)
+		double getVoltageRate(const VvvfValues& control, const YamlVvvfSoundData& sound, bool precise, bool fixSign)
+		{
+			WaveForm::EdgeList scratch;
+			return getVoltageRate(control, sound, precise, fixSign, scratch);
+		}
+		double getVoltageRate(const VvvfValues& control, const YamlVvvfSoundData& sound, bool precise, bool fixSign, WaveForm::EdgeList& scratch)
 		{
-			auto PWM_Array = WaveForm::getUVWCycle(control, sound, InternalMath::M_PI_6, 120000, precise);
-			return getVoltageRate(PWM_Array, fixSign);
+			WaveForm::getUVWCycleEdges(control, sound, InternalMath::M_PI_6, 120000, precise, WaveForm::EdgeSolver::Analytic, scratch);
+			return getVoltageRate(scratch, fixSign);
 		}
-		double getVoltageRate(const QVector<WaveValues>& UVW, bool fixSign = true)
+		double getVoltageRate(const QVector<WaveValues>& UVW, bool fixSign)
 		{
 			double result = getFourierFast(UVW, 1) / VoltageConvertFactor;
 			if (fixSign) result = std::fabs(result);
 			return result;
 		}
+		double getVoltageRate(const WaveForm::EdgeList& UVW, bool fixSign)
+		{
+			// The first harmonic is the only one needed: a direct sum over the edges
+			const FourierEdges edges = getFourierEdges(UVW);
+			double sum = 0.0;
+			for (size_t k = 0; k < edges.angles.size(); k++) sum += edges.weights[k] * std::cos(edges.angles[k]);
+			double result = sum / InternalMath::M_2PI / VoltageConvertFactor;
+			if (fixSign) result = std::fabs(result);
+			return result;
+		}
+		}
 	}
 }
@@ -1,6 +1,8 @@
 // Internal Includes
 #include "../Vvvf/Struct.hpp"
 #include "../Yaml/VvvfSound/YamlVvvfAnalyze.hpp"
+// STL Includes
+#include <vector>
 // Package Includes
 #include <QVector>
 
@@ -36,6 +38,97 @@ namespace VvvfSimulator::Generation
 			QVector<WaveValues> getUVWSec(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, qsizetype division, bool precise);
 
 			QVector<WaveValues> getUVW(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, double invDeltaT, qsizetype count);
+
+			/// <summary>
+			/// How the switching events of an EdgeList are found.
+			/// </summary>
+			enum class EdgeSolver
+			{
+				/// Evaluate the modulator on every sample and keep the changes
+				Sampled,
+				/// Solve for the exact carrier/reference crossing instants, carrier
+				/// half-period by half-period. Only the two-level asynchronous sine
+				/// patterns (the ones getUVW() batches) are solved this way; the
+				/// others are sampled.
+				Analytic
+			};
+
+			/// <summary>
+			/// Run-length form of a sampled UVW waveform. The signal is piecewise
+			/// constant with a few dozen transitions per cycle, so it is stored as
+			/// the sample index of each switching event and the state it switches
+			/// to, instead of one WaveValues per sample.
+			/// </summary>
+			struct EdgeList
+			{
+				struct Edge
+				{
+					/// First sample holding state
+					qsizetype index = 0;
+					WaveValues state;
+					/// Switching instant; index / invDeltaT unless exactTimes
+					double time = 0.0;
+				};
+
+				/// Ordered by index; the first edge, if any, is at sample 0
+				std::vector<Edge> edges;
+				/// Number of samples described, i.e. the size of the dense form
+				qsizetype sampleCount = 0;
+				/// Sampling rate; sample i is at time i / invDeltaT
+				double invDeltaT = 0.0;
+				/// Edge times are solved crossing instants rather than sample times;
+				/// index is then the first sample after the crossing.
+				bool exactTimes = false;
+
+				qsizetype size() const noexcept { return sampleCount; }
+				bool isEmpty() const noexcept { return sampleCount == 0; }
+
+				/// <summary>
+				/// Samples from edges[k] up to the next edge (or the end).
+				/// </summary>
+				qsizetype runLength(size_t k) const noexcept
+				{
+					return (k + 1 < edges.size() ? edges[k + 1].index : sampleCount) - edges[k].index;
+				}
+
+				/// <summary>
+				/// Records the state of sample index, which must not precede the
+				/// last recorded one. Only actual changes become edges.
+				/// </summary>
+				void append(qsizetype index, const WaveValues& state)
+				{
+					if (edges.empty() || edges.back().state != state)
+						edges.push_back({ index, state, invDeltaT > 0.0 ? index / invDeltaT : 0.0 });
+				}
+
+				/// <summary>
+				/// State of sample i, by binary search over the edges.
+				/// </summary>
+				WaveValues at(qsizetype i) const;
+
+				QVector<WaveValues> toDense() const;
+				static EdgeList fromDense(const QVector<WaveValues>& UVW, double invDeltaT = 0.0);
+			};
+
+			/// <summary>
+			/// Same sampling as getUVWCycle(), emitted as switching events.
+			/// </summary>
+			EdgeList getUVWCycleEdges(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, qsizetype division, bool precise, EdgeSolver solver = EdgeSolver::Sampled);
+			void getUVWCycleEdges(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, qsizetype division, bool precise, EdgeSolver solver, EdgeList& out);
+
+			/// <summary>
+			/// Same samples as getUVW(), emitted as switching events without ever
+			/// holding the dense array. With EdgeSolver::Analytic the cost no
+			/// longer depends on count, which then only sets the sample grid the
+			/// edge indices refer to.
+			/// </summary>
+			EdgeList getUVWEdges(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, double invDeltaT, qsizetype count, EdgeSolver solver = EdgeSolver::Sampled);
+
+			/// <summary>
+			/// Fills out instead, reusing its storage; for callers that evaluate
+			/// many waveforms in a row.
+			/// </summary>
+			void getUVWEdges(VvvfValues control, const YamlVvvfSoundData& sound, double initialPhase, double invDeltaT, qsizetype count, EdgeSolver solver, EdgeList& out);
 		}
 		
 		namespace Fourier
@@ -44,8 +137,55 @@ namespace VvvfSimulator::Generation
 			double getFourier(const QVector<WaveValues>& UVW, qsizetype N);
 			
 			double getFourierFast(const QVector<WaveValues>& UVW, qsizetype N);
+
+			/// <summary>
+			/// Switching edges of the U-V line voltage of one sampled cycle, as
+			/// seen by getFourierFast(): the coefficient of harmonic n is
+			/// sum(weights[k] * cos(n * angles[k])) / (2 pi n).
+			/// Solved (exactTimes) edge lists also close their last run with an
+			/// edge at 2 pi, which getFourierFast() leaves out.
+			/// </summary>
+			struct FourierEdges
+			{
+				std::vector<double> angles;
+				std::vector<double> weights;
+				/// Sample index of each edge; angles[k] = 2 pi indices[k] / period
+				std::vector<qsizetype> indices;
+				/// Samples per cycle, or 0 when the angles are exact crossing
+				/// instants off the sample grid (which rules out the FFT path)
+				qsizetype period = 0;
+			};
+
+			/// <summary>
+			/// Extracts the edges in one pass over the samples.
+			/// </summary>
+			FourierEdges getFourierEdges(const QVector<WaveValues>& UVW);
+
+			/// <summary>
+			/// Same edges from the run-length form, in one pass over its events.
+			/// </summary>
+			FourierEdges getFourierEdges(const WaveForm::EdgeList& UVW);
+
+			/// <summary>
+			/// Coefficients 1 to N in one pass over the edges per harmonic,
+			/// using the angle addition recurrence instead of a cosine per edge.
+			/// </summary>
+			QVector<double> getFourierCoefficientsRecurrence(const FourierEdges& edges, qsizetype N);
+
+			/// <summary>
+			/// Coefficients 1 to N from a single FFT of the period-long edge
+			/// weight array. Preferable for large N.
+			/// </summary>
+			QVector<double> getFourierCoefficientsFFT(const FourierEdges& edges, qsizetype N);
+
+			/// <summary>
+			/// Coefficients 1 to N, same values as calling getFourierFast() for
+			/// every harmonic, through whichever of the two paths is cheaper.
+			/// </summary>
+			QVector<double> getFourierCoefficients(const FourierEdges& edges, qsizetype N);
 			
 			QVector<double> getFourierCoefficients(const QVector<WaveValues>& UVW, qsizetype N);
+			QVector<double> getFourierCoefficients(const WaveForm::EdgeList& UVW, qsizetype N);
 			
 			/// <summary>
 			/// Gets Fourier series coefficients
@@ -66,7 +206,14 @@ namespace VvvfSimulator::Generation
 			/// <param name="Control"></param>
 			/// <returns></returns>
 			double getVoltageRate(const VvvfValues& control, const YamlVvvfSoundData& sound, bool precise, bool fixSign = true);
+			/// <summary>
+			/// Same, building the cycle's edge list in scratch so that repeated calls
+			/// reuse its storage. The edge solver, getFourierEdges() and calculateYaml()
+			/// still allocate their own temporaries on every call.
+			/// </summary>
+			double getVoltageRate(const VvvfValues& control, const YamlVvvfSoundData& sound, bool precise, bool fixSign, WaveForm::EdgeList& scratch);
 			double getVoltageRate(const QVector<WaveValues>& UVW, bool fixSign = true);
+			double getVoltageRate(const WaveForm::EdgeList& UVW, bool fixSign = true);
 		}
 	}
 }
@@ -7,12 +7,21 @@
 // Version 1.9.1.1
 
 // Standard Library Includes
+#include <cstring>
+#include <utility>
 //#include <ctime>
 // Package Includes
 #include <avcpp/av.h> // Has already been included by the header above, but don't rely on indirect includes...
 #include <avcpp/averror.h>
+#include <QColor>
 #include <QObject> // Has already been included by the declaration header, but don't rely on indirect includes...
 #include <QtDebug>
+extern "C"
+{
+#include <libavutil/opt.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
 
 namespace VvvfSimulator::Generation
 {
@@ -36,10 +45,16 @@ namespace VvvfSimulator::Generation
 		m_formatContext(std::nullopt),
 		m_codecContext(std::nullopt),
 		m_stream(std::nullopt),
-		m_pixelFormat(/*pixelFormat != AV_PIX_FMT_NONE && */getQImageFormat(pixelFormat.get()) == QImage::Format_Invalid ? av::PixelFormat(bestCompatiblePixelFormat) : pixelFormat),
+		m_pixelFormat(pixelFormat.get() == AV_PIX_FMT_NONE ? av::PixelFormat(defaultPixelFormat) : pixelFormat),
 		m_pts(0),
 		m_codecID(codecID),
-		m_isOpen(false)
+		m_isOpen(false),
+		m_queueCapacity(0),
+		m_stopEncoding(false),
+		m_swsContext(nullptr),
+		m_swsSourceFormat(AV_PIX_FMT_NONE),
+		m_swsSourceWidth(0),
+		m_swsSourceHeight(0)
 	{
 		if (openOnCreation)
 			open();
@@ -47,7 +62,14 @@ namespace VvvfSimulator::Generation
 
 	QtVideoWriter::~QtVideoWriter()
 	{
-		close();
+		try
+		{
+			close();
+		}
+		catch (const std::exception &e)
+		{
+			qWarning() << QObject::tr("Failed to finish video file: %1").arg(e.what());
+		}
 	}
 
 	bool QtVideoWriter::setFilename(const std::filesystem::path &filename)
@@ -115,8 +137,9 @@ namespace VvvfSimulator::Generation
 		}
 		else
 		{
-			if (/*pixelFormat != AV_PIX_FMT_NONE && */getQImageFormat(pixelFormat.get()) == QImage::Format_Invalid) 
-				m_pixelFormat = av::PixelFormat(bestCompatiblePixelFormat);
+			// Anything the encoder takes will do, swscale converts into it
+			if (pixelFormat.get() == AV_PIX_FMT_NONE)
+				m_pixelFormat = av::PixelFormat(defaultPixelFormat);
 			else m_pixelFormat = pixelFormat;
 			return true;
 		}
@@ -136,6 +159,20 @@ namespace VvvfSimulator::Generation
 		}
 	}
 
+	bool QtVideoWriter::setQueueCapacity(size_t capacity)
+	{
+		if (m_isOpen)
+		{
+			qWarning() << QObject::tr("Cannot change queue capacity while the video writer is open");
+			return false;
+		}
+		else
+		{
+			m_queueCapacity = capacity;
+			return true;
+		}
+	}
+
 	void QtVideoWriter::open()
 	{
     if (m_isOpen) return;
@@ -156,6 +193,15 @@ namespace VvvfSimulator::Generation
 		m_codecContext->setHeight(m_height);
 		m_codecContext->setPixelFormat(m_pixelFormat);
 		m_codecContext->setTimeBase(m_timeBase);
+		// Tag what swscale writes for YUV, so players don't guess per resolution
+		if (!isRGBFormat(m_pixelFormat.get()))
+		{
+			AVCodecContext *raw = m_codecContext->raw();
+			raw->colorspace = AVCOL_SPC_BT709;
+			raw->color_primaries = AVCOL_PRI_BT709;
+			raw->color_trc = AVCOL_TRC_BT709;
+			raw->color_range = AVCOL_RANGE_MPEG;
+		}
     m_codecContext->open();
 
     m_stream.emplace(std::move(m_formatContext->addStream(reinterpret_cast<const av::VideoEncoderContext &>(*m_codecContext))));
@@ -165,58 +211,205 @@ namespace VvvfSimulator::Generation
     //m_packet.emplace();
 
     m_pts = 0;
+
+		m_framePool.clear();
+		m_encodeError = nullptr;
+		m_stopEncoding = false;
+		if (isAsynchronous()) m_encodeThread = std::thread(&QtVideoWriter::encodeLoop, this);
+
 		m_isOpen = true;
 		//return true;
 	}
 
+	bool QtVideoWriter::isRGBFormat(AVPixelFormat format) noexcept
+	{
+		const AVPixFmtDescriptor *descriptor = av_pix_fmt_desc_get(format);
+		return descriptor && (descriptor->flags & AV_PIX_FMT_FLAG_RGB);
+	}
+
+	QtVideoWriter::SharedFrame QtVideoWriter::takePoolFrame()
+	{
+		// The encoder may still reference a frame it was sent (e.g. for B-frames);
+		// only reuse the ones it has released.
+		for (const SharedFrame &frame : m_framePool)
+			if (av_frame_is_writable(frame->raw())) return frame;
+
+		m_framePool.push_back(std::make_shared<av::VideoFrame>(m_codecContext->pixelFormat(), m_codecContext->width(), m_codecContext->height(), 32));
+		return m_framePool.back();
+	}
+
+	av::VideoFrame QtVideoWriter::wrapImage(QImage image)
+	{
+		QImage *owner = new QImage(std::move(image));
+		uint8_t *bits = const_cast<uint8_t *>(owner->constBits()); // Read only, see the flag below
+		AVBufferRef *buffer = av_buffer_create(
+			bits,
+			size_t(owner->sizeInBytes()),
+			[](void *opaque, uint8_t *) { delete static_cast<QImage *>(opaque); },
+			owner,
+			AV_BUFFER_FLAG_READONLY
+		);
+		if (!buffer)
+		{
+			delete owner;
+			throw av::Exception(av::make_ffmpeg_error(AVERROR(ENOMEM)));
+		}
+
+		AVFrame *raw = av_frame_alloc();
+		raw->buf[0] = buffer;
+		raw->data[0] = bits;
+		raw->linesize[0] = int(owner->bytesPerLine());
+		raw->format = getPixelFormat(owner->format());
+		raw->width = owner->width();
+		raw->height = owner->height();
+
+		av::VideoFrame frame(raw); // Takes its own reference
+		av_frame_free(&raw);
+		return frame;
+	}
+
+	SwsContext *QtVideoWriter::getSwsContext(AVPixelFormat sourceFormat, int sourceWidth, int sourceHeight)
+	{
+		if (m_swsContext && m_swsSourceFormat == sourceFormat && m_swsSourceWidth == sourceWidth && m_swsSourceHeight == sourceHeight)
+			return m_swsContext;
+
+		sws_freeContext(m_swsContext);
+		m_swsContext = sws_alloc_context();
+		if (!m_swsContext) throw av::Exception(av::make_ffmpeg_error(AVERROR(ENOMEM)));
+		av_opt_set_int(m_swsContext, "srcw", sourceWidth, 0);
+		av_opt_set_int(m_swsContext, "srch", sourceHeight, 0);
+		av_opt_set_int(m_swsContext, "src_format", sourceFormat, 0);
+		av_opt_set_int(m_swsContext, "dstw", m_codecContext->width(), 0);
+		av_opt_set_int(m_swsContext, "dsth", m_codecContext->height(), 0);
+		av_opt_set_int(m_swsContext, "dst_format", m_codecContext->pixelFormat().get(), 0);
+		av_opt_set_int(m_swsContext, "sws_flags", SWS_BILINEAR, 0);
+		av_opt_set_int(m_swsContext, "threads", 0, 0); // Slice threads, one per core
+		if (const int ret = sws_init_context(m_swsContext, nullptr, nullptr); ret < 0)
+		{
+			sws_freeContext(m_swsContext);
+			m_swsContext = nullptr;
+			throw av::Exception(av::make_ffmpeg_error(ret));
+		}
+		if (!isRGBFormat(m_codecContext->pixelFormat().get()))
+		{
+			// Full range RGB in, limited range BT.709 out, as tagged in open()
+			const int *coefficients = sws_getCoefficients(SWS_CS_ITU709);
+			sws_setColorspaceDetails(m_swsContext, coefficients, 1, coefficients, 0, 0, 1 << 16, 1 << 16);
+		}
+
+		m_swsSourceFormat = sourceFormat;
+		m_swsSourceWidth = sourceWidth;
+		m_swsSourceHeight = sourceHeight;
+		return m_swsContext;
+	}
+
+	av::VideoFrame QtVideoWriter::convertImage(QImage image)
+	{
+		// Formats FFmpeg has no name for go through the cheapest 8 bit Qt one
+		if (getPixelFormat(image.format()) == AV_PIX_FMT_NONE)
+			image.convertTo(image.hasAlphaChannel() ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+
+		const AVPixelFormat sourceFormat = getPixelFormat(image.format());
+		const int sourceWidth = image.width(), sourceHeight = image.height();
+		av::VideoFrame source = wrapImage(std::move(image));
+
+		// Already what the encoder wants, the image itself is sent
+		if (sourceFormat == m_codecContext->pixelFormat().get() && sourceWidth == m_codecContext->width() && sourceHeight == m_codecContext->height())
+			return source;
+
+		SwsContext *swsContext = getSwsContext(sourceFormat, sourceWidth, sourceHeight);
+		SharedFrame destination = takePoolFrame();
+		if (const int ret = sws_scale_frame(swsContext, destination->raw(), source.raw()); ret < 0)
+			throw av::Exception(av::make_ffmpeg_error(ret));
+		return *destination; // A new reference to the pooled buffer
+	}
+
 	void QtVideoWriter::writeFrame(QImage image)
 	{
     if (!m_isOpen) return;
-		const auto conditionalImageScale = [&]()
-		{
-			// Resize the QImage to match the codec context dimensions
-			if (image.width() != m_codecContext->width() || image.height() != m_codecContext->height())
-			{
-				image = std::move(image.scaled(m_codecContext->width(), m_codecContext->height()));
-			}
-		};
+		submitFrame(std::move(image), 1);
+	}
 
-		const QImage::Format contextImageFormat = getQImageFormat(m_codecContext->pixelFormat().get());
-		const auto conditionalImageConvert = [&]()
+	void QtVideoWriter::submitFrame(QImage image, size_t repeat)
+	{
+		QueuedFrame queued{ std::move(image), m_pts, repeat };
+		m_pts += int64_t(repeat);
+
+		if (!isAsynchronous())
 		{
-			if (image.format() != contextImageFormat)
-			{
-				image.convertTo(contextImageFormat);
-			}
-		};
+			encodeQueuedFrame(queued);
+			return;
+		}
 
-		// Convert the image format and scale it if necessary
-		// The order of operations is important to avoid unnecessary conversions
-		if (image.format() < contextImageFormat)
 		{
-			conditionalImageConvert();
-			conditionalImageScale();
+			std::unique_lock lock(m_queueMutex);
+			m_producerCondition.wait(lock, [this]() { return m_queue.size() < m_queueCapacity || m_encodeError; });
+			if (m_encodeError) std::rethrow_exception(m_encodeError);
+			m_queue.push_back(std::move(queued));
 		}
-		else
+		m_encoderCondition.notify_one();
+	}
+
+	void QtVideoWriter::encodeQueuedFrame(QueuedFrame &queued)
+	{
+		av::VideoFrame frame = convertImage(std::move(queued.image));
+		for (size_t i = 0; i < queued.repeat; i++)
 		{
-			conditionalImageScale();
-			conditionalImageConvert();
+			frame.setPts(queued.pts + int64_t(i), m_codecContext->timeBase());
+			m_packet.emplace(std::move(static_cast<av::VideoEncoderContext*>(&(m_codecContext.value()))->encode(frame)));
+			m_formatContext->writePacket(*m_packet);
 		}
+	}
 
-    Q_ASSERT(image.width() == m_codecContext->width());
-		Q_ASSERT(image.height() == m_codecContext->height());
-		av::VideoFrame frame(image.bits(), image.sizeInBytes(), m_codecContext->pixelFormat().get(), m_codecContext->width(), m_codecContext->height());
-    frame.setPts(m_pts++, m_codecContext->timeBase());
+	void QtVideoWriter::encodeLoop()
+	{
+		for (;;)
+		{
+			QueuedFrame queued;
+			{
+				std::unique_lock lock(m_queueMutex);
+				m_encoderCondition.wait(lock, [this]() { return !m_queue.empty() || m_stopEncoding; });
+				if (m_queue.empty()) return; // Stopped and drained
+				queued = std::move(m_queue.front());
+				m_queue.pop_front();
+			}
+			m_producerCondition.notify_one();
 
-    m_packet.emplace(std::move(static_cast<av::VideoEncoderContext*>(&(m_codecContext.value()))->encode(frame)));
-    m_formatContext->writePacket(*m_packet);
+			try
+			{
+				encodeQueuedFrame(queued);
+			}
+			catch (...)
+			{
+				// Handed to the producer, which rethrows it on its next call
+				{
+					std::lock_guard lock(m_queueMutex);
+					m_encodeError = std::current_exception();
+					m_queue.clear();
+				}
+				m_producerCondition.notify_all();
+				return;
+			}
+		}
 	}
 
 	void QtVideoWriter::close()
 	{
     if (!m_isOpen) return; // Check if the video writer is already closed
 
-		if (m_formatContext)
+		// Let the encode thread drain whatever is still queued
+		if (m_encodeThread.joinable())
+		{
+			{
+				std::lock_guard lock(m_queueMutex);
+				m_stopEncoding = true;
+			}
+			m_encoderCondition.notify_one();
+			m_encodeThread.join();
+		}
+		const std::exception_ptr error = std::exchange(m_encodeError, nullptr);
+
+		if (m_formatContext && !error)
 		{
 			//static_cast<av::VideoEncoderContext*>(m_codecContext.get())->flush(m_packet);
 			m_formatContext->flush();
@@ -224,21 +417,34 @@ namespace VvvfSimulator::Generation
 			m_formatContext->writeTrailer();
     }
 		m_isOpen = false;
+		m_queue.clear();
+		m_framePool.clear();
+		sws_freeContext(m_swsContext);
+		m_swsContext = nullptr;
 		m_packet.reset();
 		m_codecContext.reset();
 		m_formatContext.reset();
 		m_stream.reset();
+		if (error) std::rethrow_exception(error);
 	}
 
 	void QtVideoWriter::addEmptyFrames(size_t numFrames, bool darkMode)
 	{
-		QImage emptyImage(width(), height(), QImage::Format_ARGB32);
-		emptyImage.fill(darkMode ? QColorConstants::Black : QColorConstants::White);
-		for (auto i = numFrames; i-- > 0;) writeFrame(emptyImage);
+    if (!m_isOpen || numFrames == 0) return;
+
+		// Kept for the opening and closing blanks alike; each call is converted once
+		const QColor colour = darkMode ? QColorConstants::Black : QColorConstants::White;
+		if (m_blankImage.size() != QSize(width(), height()) || m_blankImage.pixelColor(0, 0) != colour)
+		{
+			m_blankImage = QImage(width(), height(), QImage::Format_RGB32);
+			m_blankImage.fill(colour);
+		}
+		submitFrame(m_blankImage, numFrames);
 	}
 	
 	void QtVideoWriter::addImageFrames(const QImage &image, size_t numFrames)
 	{
-		for (auto i = numFrames; i-- > 0;) writeFrame(image);
+    if (!m_isOpen || numFrames == 0) return;
+		submitFrame(image, numFrames);
 	}
-}
\ No newline at end of file
+}
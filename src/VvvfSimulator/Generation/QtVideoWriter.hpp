@@ -8,11 +8,17 @@
 
 // Standard Library
 #include <cinttypes>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <variant>
+#include <vector>
 // Packages
 #include <avcpp/av.h>
 #include <avcpp/codec.h>
@@ -25,6 +31,8 @@
 #include <QObject>
 #include <QImage>
 
+struct SwsContext;
+
 namespace VvvfSimulator::Generation
 {
 	class QtVideoWriter : public QObject
@@ -46,10 +54,54 @@ namespace VvvfSimulator::Generation
 		//av::VideoFrame m_frame;
 		int64_t m_pts; // size : 8 bytes
 		bool m_isOpen; // size : 1 byte
+
+		// Frames handed to the encoder. The QImage is only shared, not copied; it's
+		// converted once on the thread that encodes it, then sent `repeat` times.
+		using SharedFrame = std::shared_ptr<av::VideoFrame>;
+		struct QueuedFrame
+		{
+			QImage image;
+			int64_t pts;
+			size_t repeat;
+		};
+
+		// Asynchronous mode: the producer only queues, the encode thread converts
+		// and does encode + writePacket. A full queue blocks writeFrame(), which
+		// bounds the memory held by frames in flight.
+		size_t m_queueCapacity; // 0 : synchronous
+		std::deque<QueuedFrame> m_queue;
+		std::mutex m_queueMutex;
+		std::condition_variable m_encoderCondition; // Wakes the encode thread
+		std::condition_variable m_producerCondition; // Wakes writeFrame()
+		std::exception_ptr m_encodeError;
+		std::thread m_encodeThread;
+		bool m_stopEncoding;
+
+		// Only touched by the thread that encodes
+		std::vector<SharedFrame> m_framePool; // In the codec's pixel format and size
+		SwsContext *m_swsContext;
+		AVPixelFormat m_swsSourceFormat;
+		int m_swsSourceWidth, m_swsSourceHeight;
+
+		QImage m_blankImage;
+
+		static bool isRGBFormat(AVPixelFormat format) noexcept;
+		SharedFrame takePoolFrame();
+		// Wraps the image bits as a refcounted frame that keeps the QImage alive
+		static av::VideoFrame wrapImage(QImage image);
+		SwsContext *getSwsContext(AVPixelFormat sourceFormat, int sourceWidth, int sourceHeight);
+		av::VideoFrame convertImage(QImage image);
+		void submitFrame(QImage image, size_t repeat);
+		void encodeQueuedFrame(QueuedFrame &queued);
+		void encodeLoop();
 	public:
 		static constexpr AVPixelFormat bestCompatiblePixelFormat = AV_PIX_FMT_RGBAF32;
 		static constexpr QImage::Format bestCompatibleImageFormat = QImage::Format_RGBA32FPx4;
 		static constexpr QImage::Format bestCompatiblePremultipliedImageFormat = QImage::Format_RGBA32FPx4_Premultiplied;
+		// What H.264/HEVC encoders take natively; swscale converts into it
+		static constexpr AVPixelFormat defaultPixelFormat = AV_PIX_FMT_YUV420P;
+		// A few frames are enough to keep the encoder busy while the next one renders
+		static constexpr size_t defaultQueueCapacity = 4;
 		//size_t m_s = sizeof(*this);
 	
 		explicit QtVideoWriter(
@@ -58,7 +110,7 @@ namespace VvvfSimulator::Generation
 			const int height,
 			const av::Rational &timeBase,
 			const AVCodecID codecID,
-			const av::PixelFormat pixelFormat = av::PixelFormat(bestCompatiblePixelFormat),
+			const av::PixelFormat pixelFormat = av::PixelFormat(defaultPixelFormat),
 			const av::Dictionary &options = av::Dictionary(),
 			bool openOnCreation = false,
 			QObject* parent = nullptr);
@@ -73,6 +125,8 @@ namespace VvvfSimulator::Generation
 		constexpr av::PixelFormat pixelFormat() const noexcept { return m_pixelFormat; }
 		constexpr int64_t pts() const noexcept { return m_pts; }
 		constexpr AVCodecID codecID() const noexcept { return m_codecID; }
+		constexpr size_t queueCapacity() const noexcept { return m_queueCapacity; }
+		constexpr bool isAsynchronous() const noexcept { return m_queueCapacity != 0; }
 		constexpr bool isOpen() const noexcept { return m_isOpen; }
 
 		double FPS() const noexcept { return m_timeBase.getDouble(); }
@@ -91,9 +145,11 @@ namespace VvvfSimulator::Generation
 				return AV_PIX_FMT_PAL8;
 			case QImage::Format_RGB32:
 				return AV_PIX_FMT_RGB32;
+			// Stored as native-endian 32 bit words (B,G,R,A bytes on little
+			// endian), exactly like Format_RGB32
 			case QImage::Format_ARGB32:
 			case QImage::Format_ARGB32_Premultiplied:
-				return AV_PIX_FMT_ARGB;
+				return AV_PIX_FMT_RGB32;
 			case QImage::Format_RGB16:
 				return AV_PIX_FMT_RGB565;
 			case QImage::Format_RGB555:
@@ -220,10 +276,14 @@ namespace VvvfSimulator::Generation
 		bool setTimeBase(const av::Rational &timeBase);
 		bool setPixelFormat(av::PixelFormat pixelFormat);
 		bool setCodecID(AVCodecID codecID);
+		// Frames writeFrame() may queue ahead of the encode thread before it
+		// blocks; 0 encodes on the caller's thread instead.
+		bool setQueueCapacity(size_t capacity);
 
 		// Throws: av::Exception
 		void open();
-		// Throws: av::Exception
+		// Throws: av::Exception, also for errors of the encode thread in
+		// asynchronous mode, which surface on the next call.
 		void writeFrame(QImage frame);
 		// Closes the video writer and releases any resources.
 		// Throws: av::Exception if there is an error during closing.
@@ -0,0 +1,148 @@
+#pragma once
+
+// Standard Library
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+namespace VvvfSimulator::Generation::Util
+{
+	/*
+	@brief Wait-free single-producer/single-consumer ring buffer.
+
+	The capacity is rounded up to a power of two and allocated once on
+	construction, so neither side ever allocates nor reorganizes memory.
+	Positions are free-running counters masked on access; the producer only
+	ever stores m_head and the consumer only ever stores m_tail, each on its
+	own cache line together with the cached copy of the other side's counter.
+
+	Exactly one thread may call the producer methods (push(), writeAvailable())
+	and exactly one thread the consumer methods (pop(), readAvailable()) at a
+	time. reset() requires both sides to be idle.
+	*/
+	template <typename T>
+	class SpscRingBuffer
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "SpscRingBuffer only handles trivially copyable types.");
+
+	public:
+		using size_type = std::size_t;
+		using value_type = T;
+
+		// Fixed instead of std::hardware_destructive_interference_size, which
+		// isn't available everywhere and warns about ABI stability elsewhere;
+		// matches the platform configurations in Util/SIMD.cpp.
+		static constexpr size_type CacheLineSize = 64;
+
+		explicit SpscRingBuffer(size_type minCapacity = 16384)
+			: m_capacity(std::bit_ceil(std::max<size_type>(minCapacity, 2)))
+			, m_mask(m_capacity - 1)
+			, m_data(new T[m_capacity]())
+		{}
+
+		SpscRingBuffer(const SpscRingBuffer &) = delete;
+		SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+		constexpr size_type capacity() const noexcept { return m_capacity; }
+
+		/// Approximate fill level; exact only when called from either side.
+		size_type size() const noexcept
+		{
+			return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+		}
+		bool empty() const noexcept { return size() == 0; }
+
+		// ===== Producer side =====
+
+		size_type writeAvailable() const noexcept
+		{
+			return m_capacity - (m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_acquire));
+		}
+
+		/*
+		@brief Appends as many elements of the input as currently fit.
+		@returns How many elements were written; less than input.size() when
+		the buffer is full.
+		*/
+		size_type push(std::span<const T> input) noexcept
+		{
+			const size_type head = m_head.load(std::memory_order_relaxed);
+			size_type free = m_capacity - (head - m_producerTail);
+			if (free < input.size())
+			{
+				m_producerTail = m_tail.load(std::memory_order_acquire);
+				free = m_capacity - (head - m_producerTail);
+			}
+			const size_type count = std::min(free, input.size());
+			copyIn(head, input.first(count));
+			m_head.store(head + count, std::memory_order_release);
+			return count;
+		}
+
+		// ===== Consumer side =====
+
+		size_type readAvailable() const noexcept
+		{
+			return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed);
+		}
+
+		/*
+		@brief Removes up to output.size() elements, oldest first.
+		@returns How many elements were read; less than output.size() when the
+		buffer ran empty.
+		*/
+		size_type pop(std::span<T> output) noexcept
+		{
+			const size_type tail = m_tail.load(std::memory_order_relaxed);
+			size_type available = m_consumerHead - tail;
+			if (available < output.size())
+			{
+				m_consumerHead = m_head.load(std::memory_order_acquire);
+				available = m_consumerHead - tail;
+			}
+			const size_type count = std::min(available, output.size());
+			copyOut(tail, output.first(count));
+			m_tail.store(tail + count, std::memory_order_release);
+			return count;
+		}
+
+		/// Drops all contents. Neither side may be active during the call.
+		void reset() noexcept
+		{
+			m_head.store(0, std::memory_order_relaxed);
+			m_tail.store(0, std::memory_order_relaxed);
+			m_producerTail = m_consumerHead = 0;
+		}
+
+	private:
+		void copyIn(size_type position, std::span<const T> input) noexcept
+		{
+			const size_type offset = position & m_mask;
+			const size_type first = std::min(input.size(), m_capacity - offset);
+			std::copy_n(input.data(), first, m_data.get() + offset);
+			std::copy_n(input.data() + first, input.size() - first, m_data.get());
+		}
+
+		void copyOut(size_type position, std::span<T> output) const noexcept
+		{
+			const size_type offset = position & m_mask;
+			const size_type first = std::min(output.size(), m_capacity - offset);
+			std::copy_n(m_data.get() + offset, first, output.data());
+			std::copy_n(m_data.get(), output.size() - first, output.data() + first);
+		}
+
+		const size_type m_capacity, m_mask;
+		const std::unique_ptr<T[]> m_data;
+
+		// Producer owned
+		alignas(CacheLineSize) std::atomic<size_type> m_head{0};
+		size_type m_producerTail = 0;
+		// Consumer owned
+		alignas(CacheLineSize) std::atomic<size_type> m_tail{0};
+		size_type m_consumerHead = 0;
+	};
+}
@@ -19,8 +19,143 @@
 // GenerateControlCommon.cpp
 // Version 1.9.1.1
 
+// Standard Library
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <shared_mutex>
+// Packages
+#include <QHash>
+
 namespace VvvfSimulator::Generation::Video::ControlInfo::GenerateControlCommon
 {
+	namespace
+	{
+		// Read mostly: after the first frames every lookup is a hit
+		template <typename T>
+		class SharedCache
+		{
+			mutable std::shared_mutex m_mutex;
+			QHash<QString, T> m_values;
+			qsizetype m_limit;
+
+		public:
+			explicit SharedCache(qsizetype limit) : m_limit(limit) {}
+
+			template <typename Make>
+			T get(const QString &key, Make &&make)
+			{
+				{
+					std::shared_lock lock(m_mutex);
+					const auto it = m_values.constFind(key);
+					if (it != m_values.constEnd()) return *it;
+				}
+				T value = make();
+				std::unique_lock lock(m_mutex);
+				// Readouts keep producing new texts, don't let long runs pile them up
+				if (m_values.size() >= m_limit) m_values.clear();
+				m_values.insert(key, value);
+				return value;
+			}
+		};
+
+		SharedCache<Qt::AlignmentFlag> alignments(256);
+		SharedCache<QFont> fittedFonts(8192);
+		SharedCache<std::shared_ptr<const DigitGlyphs>> digitGlyphs(64);
+
+		std::shared_ptr<const DigitGlyphs> makeDigitGlyphs(const QFont &font, const QColor &color)
+		{
+			const QFontMetricsF metrics(font);
+			auto glyphs = std::make_shared<DigitGlyphs>();
+			glyphs->ascent = metrics.ascent();
+			glyphs->descent = metrics.descent();
+			glyphs->padding = int(std::ceil(metrics.height() / 4));
+
+			const int height = int(std::ceil(metrics.height())) + 2 * glyphs->padding;
+			for (qsizetype i = 0; i < DigitGlyphs::characters.size(); i++)
+			{
+				const QChar character = DigitGlyphs::characters[i];
+				glyphs->advances[i] = metrics.horizontalAdvance(character);
+
+				QImage &image = glyphs->images[i];
+				image = QImage(int(std::ceil(glyphs->advances[i])) + 2 * glyphs->padding, height, QImage::Format_ARGB32_Premultiplied);
+				image.fill(Qt::transparent);
+				QPainter painter(&image);
+				painter.setFont(font);
+				painter.setPen(color);
+				painter.drawText(QPointF(glyphs->padding, glyphs->padding + glyphs->ascent), QString(character));
+			}
+			return glyphs;
+		}
+	}
+
+	Qt::AlignmentFlag getAlignment(const QString &family)
+	{
+		return alignments.get(family, [&family]()
+		{
+			constexpr std::array<QFontDatabase::WritingSystem, 4> RTLWritingSystems
+				{QFontDatabase::Arabic, QFontDatabase::Hebrew, QFontDatabase::Syriac, QFontDatabase::Thaana};
+			const auto writingSystems = QFontDatabase::writingSystems(family);
+			for (const auto &ws : writingSystems)
+				if (std::find(RTLWritingSystems.begin(), RTLWritingSystems.end(), ws) != RTLWritingSystems.end())
+					return Qt::AlignRight;
+			return Qt::AlignLeft;
+		});
+	}
+
+	QFont fitFont(const QString &text, const QFont &font, qreal width, bool integralSizes)
+	{
+		const QString key = font.key() + QChar(integralSizes ? u'i' : u'f') + QString::number(width) + QChar(0) + text;
+		return fittedFonts.get(key, [&]()
+		{
+			QFont fitted = font;
+			if (integralSizes)
+			{
+				while (QFontMetrics(fitted).horizontalAdvance(text) > width && fitted.pointSize() > 1)
+					fitted.setPointSize(fitted.pointSize() - 1);
+			}
+			else
+			{
+				while (QFontMetricsF(fitted).horizontalAdvance(text) > width && fitted.pointSizeF() > 1)
+					fitted.setPointSizeF(fitted.pointSizeF() - 1);
+			}
+			return fitted;
+		});
+	}
+
+	std::shared_ptr<const DigitGlyphs> getDigitGlyphs(const QFont &font, const QColor &color)
+	{
+		const QString key = font.key() + QChar(0) + QString::number(color.rgba64(), 16);
+		return digitGlyphs.get(key, [&]() { return makeDigitGlyphs(font, color); });
+	}
+
+	bool drawDigits(QPainter &painter, const QRectF &rect, const QString &text, const QFont &font, Qt::Alignment alignment, const QColor &color)
+	{
+		if (!std::all_of(text.begin(), text.end(), [](QChar character) { return DigitGlyphs::indexOf(character) >= 0; }))
+			return false;
+
+		const std::shared_ptr<const DigitGlyphs> glyphs = getDigitGlyphs(font, color);
+		qreal width = 0;
+		for (const QChar character : text) width += glyphs->advances[DigitGlyphs::indexOf(character)];
+
+		qreal x = rect.left();
+		if (alignment & Qt::AlignRight) x = rect.right() - width;
+		else if (alignment & Qt::AlignHCenter) x = rect.center().x() - width / 2;
+
+		const qreal lineHeight = glyphs->ascent + glyphs->descent;
+		qreal top = rect.top();
+		if (alignment & Qt::AlignBottom) top = rect.bottom() - lineHeight;
+		else if (alignment & Qt::AlignVCenter) top = rect.center().y() - lineHeight / 2;
+
+		for (const QChar character : text)
+		{
+			const qsizetype index = DigitGlyphs::indexOf(character);
+			painter.drawImage(QPointF(std::round(x) - glyphs->padding, std::round(top) - glyphs->padding), glyphs->images[index]);
+			x += glyphs->advances[index];
+		}
+		return true;
+	}
+
 	void filledCornerCurvedRectangle(QPainter &painter, const QBrush &brush, const QPoint &start, const QPoint &end, int roundRadius)
 	{
     const int width = end.x() - start.x();
@@ -21,18 +21,23 @@
 
 // Standard Library
 #include <array>
+#include <memory>
 #include <utility>
 // Packages
 #include <QBrush>
+#include <QColor>
 #include <QFont>
 #include <QFontDatabase>
 #include <QFontMetrics>
 #include <QFontMetricsF>
+#include <QImage>
 #include <QPainter>
 #include <QPen>
 #include <QPoint>
+#include <QRectF>
 #include <QSize>
 #include <QString>
+#include <QStringView>
 
 namespace VvvfSimulator::Generation::Video::ControlInfo::GenerateControlCommon
 {
@@ -87,34 +92,57 @@ namespace VvvfSimulator::Generation::Video::ControlInfo::GenerateControlCommon
 		const QPoint &strCompen
 	);
 
-	inline Qt::AlignmentFlag getAlignment(const QString &family)
-	{
-		constexpr std::array<QFontDatabase::WritingSystem, 4> RTLWritingSystems
-			{QFontDatabase::Arabic, QFontDatabase::Hebrew, QFontDatabase::Syriac, QFontDatabase::Thaana};
-		const auto writingSystems = QFontDatabase::writingSystems(family);
-    for (const auto &ws : writingSystems)
-			if (std::find(RTLWritingSystems.begin(), RTLWritingSystems.end(), ws) != RTLWritingSystems.end())
-				return Qt::AlignRight;
-    return Qt::AlignLeft;
-	}
+	// Cached per family, QFontDatabase is slow to ask. Any thread.
+	Qt::AlignmentFlag getAlignment(const QString &family);
 
 	inline Qt::AlignmentFlag getAlignment(const QFont &font)
 	{
 		return getAlignment(font.family());
 	}
 
+	/*
+	Shrinks the font one point at a time until the text fits the width, like
+	drawTextAutoScale() always did. The result is cached for every control info
+	generator, keyed by font (family and starting size), width and text, so
+	each frame only measures what it hasn't shown before. Any thread.
+	*/
+	QFont fitFont(const QString &text, const QFont &font, qreal width, bool integralSizes = false);
+
 	// Function to draw text with auto-scaling font
-	inline void drawTextAutoScale(QPainter &painter, const QRect &rect, const QString &text, QFont font, Qt::AlignmentFlag flags = 0) {
-		while (QFontMetrics(font).horizontalAdvance(text) > rect.width() && font.pointSize() > 1)
-			font.setPointSize(font.pointSize() - 1);
-		painter.setFont(font);
+	inline void drawTextAutoScale(QPainter &painter, const QRect &rect, const QString &text, const QFont &font, Qt::AlignmentFlag flags = 0) {
+		painter.setFont(fitFont(text, font, rect.width(), true));
 		painter.drawText(rect, flags, text);
 	}
 	
-	inline void drawTextAutoScale(QPainter &painter, const QRectF &rect, const QString &text, QFont font, Qt::AlignmentFlag flags = 0) {
-		while (QFontMetricsF(font).horizontalAdvance(text) > rect.width() && font.pointSizeF() > 1)
-			font.setPointSizeF(font.pointSizeF() - 1);
-		painter.setFont(font);
+	inline void drawTextAutoScale(QPainter &painter, const QRectF &rect, const QString &text, const QFont &font, Qt::AlignmentFlag flags = 0) {
+		painter.setFont(fitFont(text, font, rect.width()));
 		painter.drawText(rect, flags, text);
 	}
+
+	/*
+	Pre-rasterized glyphs for the characters of numeric readouts, in one font
+	and colour. Blitting these is much cheaper than shaping and rasterizing the
+	same few glyphs again on every frame.
+	*/
+	struct DigitGlyphs
+	{
+		static constexpr QStringView characters = u"0123456789.,-+% ";
+
+		std::array<QImage, characters.size()> images; // Premultiplied, padded
+		std::array<qreal, characters.size()> advances;
+		qreal ascent, descent;
+		int padding;
+
+		static qsizetype indexOf(QChar character) { return characters.indexOf(character); }
+	};
+
+	// Shared between threads, built on first use per font and colour
+	std::shared_ptr<const DigitGlyphs> getDigitGlyphs(const QFont &font, const QColor &color);
+
+	/*
+	Draws the text like QPainter::drawText(rect, alignment, text) from the
+	cached digit glyphs. Returns false, drawing nothing, if the text has a
+	character outside DigitGlyphs::characters.
+	*/
+	bool drawDigits(QPainter &painter, const QRectF &rect, const QString &text, const QFont &font, Qt::Alignment alignment, const QColor &color);
 }
\ No newline at end of file
@@ -1,165 +1,222 @@
 #include "GenerateControlOriginal.hpp"
 
 // Standard Library
-#include <optional>
+#include <array>
 // Packages
-#include <QApplication>
 #include <QColor>
 #include <QFontDatabase>
 #include <QFontMetricsF>
-#include <QFuture>
 #include <QLinearGradient>
 #include <QObject>
 #include <QPainter>
 #include <QPointF>
-#include <QtConcurrent/QtConcurrent>
+#include <QRegion>
 // Internal
 #include "GenerateControlCommon.hpp"
+#include "../FramePipeline.hpp"
 
 namespace VvvfSimulator::Generation::Video::ControlInfo
 {
-	QImage GenerateControlOriginal::getImage(
-		const VvvfValues &control,
-		bool finalShow,
-		int width,
-		int height,
-		const QFont &titleFnt,
-		const QFont &valFnt,
-		const QFont &valMiniFnt,
-		bool darkMode)
+	namespace
 	{
-		using GenerateControlCommon::getAlignment;
-
-		QImage image(width, height, QImage::Format_RGB32);
-		QPainter painter(&image);
-
-		QColor gradationColor;
-		if (control.freeRun)
-			gradationColor = QColor(0xE0, 0xFD, 0xE0);
-		else gradationColor = control.brake ? QColor(0xFD, 0xE0, 0xE0) : QColor(0xE0, 0xE0, 0xFD);
-
-		QLinearGradient gradient(QPointF(0.0, 0.0), QPointF(image.width(), image.height()));
-		gradient.setColorAt(0.0, darkMode ? QColorConstants::Black : QColorConstants::White);
-		gradient.setColorAt(1.0, gradationColor);
-
-		painter.setBrush(QBrush(gradient));
-		painter.drawRect(0, 0, image.width(), image.height());
-
-		// Scaling factors
-		const qreal xScale = static_cast<qreal>(width) / 500.0;
-		const qreal yScale = static_cast<qreal>(height) / 1080.0;
-
-		// Draw the top rectangle
-		painter.setBrush(QColor(200, 200, 255));
-		painter.drawRect(QRectF(0, 0, image.width(), 68 * yScale));
-
-		// Set text brush
-		const QBrush textBrush(darkMode ? QColorConstants::White : QColorConstants::Black);
-		painter.setBrush(textBrush);
-
-		// Function to draw text with auto-scaling font
-		const auto drawTextAutoScale = [&](const QRectF &rect, const QString &text, QFont font) {
-			QFontMetricsF metrics(font);
-			while (metrics.horizontalAdvance(text) > rect.width() && font.pointSizeF() > 1) {
-				font.setPointSizeF(font.pointSizeF() - 1);
-				metrics = QFontMetricsF(font);
-			}
-			painter.setFont(font);
-			painter.drawText(rect, getAlignment(font.family()) | Qt::AlignTop, text);
-		};
-
-		// Draw "Pulse Mode" text
-		drawTextAutoScale(QRectF(17 * xScale, 8 * yScale, image.width() - 34 * xScale, titleFnt.pointSizeF()), QObject::tr("Pulse Mode"), titleFnt);
-
-		// Draw the blue separator
-		painter.setBrush(QColorConstants::Blue);
-		painter.drawRect(QRectF(0, 68 * yScale, image.width(), 8 * yScale));
-
-		if (!finalShow)
+		/*
+		Renders the original control info frames in two layers: the background
+		(gradient, header bars and titles) is only drawn again when its look
+		changes, and of the values only the ones whose text changed since the
+		previous frame are repainted over it. Each thread keeps its own renderer,
+		so "previous" means the last frame that thread rendered.
+		*/
+		class OriginalRenderer
 		{
-			const QStringList pulseName = control.getPulseName();
+			// The value texts, in the 500x1080 reference frame
+			enum Slot { PulseName0, PulseName1, PulseName2, SineFreq, SineAmplitude, Freerun, Brake, SlotCount };
 
-			painter.setBrush(textBrush);
-			drawTextAutoScale(QRectF(17 * xScale, 100 * yScale, image.width() - 34 * xScale, valFnt.pointSizeF()), pulseName[0], valFnt);
-
-			if (pulseName.size() == 2)
+			struct Region
 			{
-				drawTextAutoScale(QRectF(17 * xScale, 170 * yScale, image.width() - 34 * xScale, valMiniFnt.pointSizeF()), pulseName[1], valMiniFnt);
-			}
-			else if (pulseName.size() >= 3)
+				QRectF rect;
+				QString text;
+				QFont font;
+				Qt::Alignment alignment;
+				QRect drawn; // What the text covered, empty if nothing
+			};
+
+			QImage m_background, m_frame;
+			QSize m_size;
+			bool m_darkMode = false;
+			QColor m_gradationColor;
+			QFont m_titleFnt, m_valFnt, m_valMiniFnt;
+			std::array<Region, SlotCount> m_regions;
+
+			static void drawText(QPainter &painter, const QRectF &rect, const QString &text, const QFont &font)
 			{
-				drawTextAutoScale(QRectF(17 * xScale, 160 * yScale, image.width() - 34 * xScale, valMiniFnt.pointSizeF()), pulseName[1], valMiniFnt);
-				drawTextAutoScale(QRectF(17 * xScale, 180 * yScale, image.width() - 34 * xScale, valMiniFnt.pointSizeF()), pulseName[2], valMiniFnt);
+				const QFont fitted = GenerateControlCommon::fitFont(text, font, rect.width());
+				painter.setFont(fitted);
+				painter.drawText(rect, GenerateControlCommon::getAlignment(fitted.family()) | Qt::AlignTop, text);
 			}
-		}
-
-		// Draw Sine Frequency text
-		painter.setBrush(QColor(200, 200, 255));
-		painter.drawRect(QRectF(0, 226 * yScale, image.width(), 65 * yScale));
-
-		painter.setBrush(textBrush);
-		drawTextAutoScale(QRectF(17 * xScale, 231 * yScale, image.width() - 34 * xScale, titleFnt.pointSizeF()), QObject::tr("Sine Freq[Hz]"), titleFnt);
-
-		painter.setBrush(QColorConstants::Blue);
-		painter.drawRect(QRectF(0, 291 * yScale, image.width(), 8 * yScale));
-
-		const double &sineFreq = control.videoSineFrequency;
-		if (!finalShow)
-		{
-			painter.setBrush(textBrush);
-			drawTextAutoScale(QRectF(17 * xScale, 323 * yScale, image.width() - 34 * xScale, valFnt.pointSizeF()), QString::number(sineFreq, 'f', 2), valFnt);
-		}
-
-		// Draw Sine Amplitude text
-		painter.setBrush(QColor(200, 200, 255));
-		painter.drawRect(QRectF(0, 447 * yScale, image.width(), 66 * yScale));
-
-		painter.setBrush(textBrush);
-		drawTextAutoScale(QRectF(17 * xScale, 452 * yScale, image.width() - 34 * xScale, titleFnt.pointSizeF()), QObject::tr("Sine Amplitude[%]"), titleFnt);
 
-		painter.setBrush(QColorConstants::Blue);
-		painter.drawRect(QRectF(0, 513 * yScale, image.width(), 8 * yScale));
-
-		if (!finalShow)
-		{
-			const double &sineAmp = control.videoSineAmplitude;
-			painter.setBrush(textBrush);
-			drawTextAutoScale(QRectF(17 * xScale, 548 * yScale, image.width() - 34 * xScale, valFnt.pointSizeF()), QString::number(sineAmp * 100, 'f', 2), valFnt);
-		}
-
-		// Draw Freerun text
-		painter.setBrush(QColor(240, 240, 240));
-		painter.drawRect(QRectF(0, 669 * yScale, image.width(), 66 * yScale));
-
-		painter.setBrush(textBrush);
-		drawTextAutoScale(QRectF(17 * xScale, 674 * yScale, image.width() - 34 * xScale, titleFnt.pointSizeF()), QObject::tr("Freerun"), titleFnt);
+			void renderBackground()
+			{
+				const int width = m_size.width(), height = m_size.height();
+				m_background = QImage(m_size, QImage::Format_RGB32);
+				QPainter painter(&m_background);
+
+				QLinearGradient gradient(QPointF(0.0, 0.0), QPointF(width, height));
+				gradient.setColorAt(0.0, m_darkMode ? QColorConstants::Black : QColorConstants::White);
+				gradient.setColorAt(1.0, m_gradationColor);
+
+				painter.setBrush(QBrush(gradient));
+				painter.drawRect(0, 0, width, height);
+
+				// Scaling factors
+				const qreal xScale = static_cast<qreal>(width) / 500.0;
+				const qreal yScale = static_cast<qreal>(height) / 1080.0;
+
+				// Header bars and titles: {bar top, bar height, separator top, bar colour, separator colour, title}
+				struct Header { qreal top, height, separator; QColor bar, line; QString title; };
+				const std::array<Header, 5> headers = {{
+					{ 0, 68, 68, QColor(200, 200, 255), QColorConstants::Blue, QObject::tr("Pulse Mode") },
+					{ 226, 65, 291, QColor(200, 200, 255), QColorConstants::Blue, QObject::tr("Sine Freq[Hz]") },
+					{ 447, 66, 513, QColor(200, 200, 255), QColorConstants::Blue, QObject::tr("Sine Amplitude[%]") },
+					{ 669, 66, 735, QColor(240, 240, 240), QColorConstants::LightGray, QObject::tr("Freerun") },
+					{ 847, 66, 913, QColor(240, 240, 240), QColorConstants::LightGray, QObject::tr("Brake") },
+				}};
+				for (const Header &header : headers)
+				{
+					painter.setBrush(header.bar);
+					painter.drawRect(QRectF(0, header.top * yScale, width, header.height * yScale));
+					drawText(painter, QRectF(17 * xScale, (header.top + (header.top == 0 ? 8 : 5)) * yScale, width - 34 * xScale, m_titleFnt.pointSizeF()), header.title, m_titleFnt);
+					painter.setBrush(header.line);
+					painter.drawRect(QRectF(0, header.separator * yScale, width, 8 * yScale));
+				}
+			}
 
-		painter.setBrush(QColorConstants::LightGray);
-		painter.drawRect(QRectF(0, 735 * yScale, image.width(), 8 * yScale));
+		public:
+			QImage render(
+				const VvvfValues &control,
+				bool finalShow,
+				int width,
+				int height,
+				const QFont &titleFnt,
+				const QFont &valFnt,
+				const QFont &valMiniFnt,
+				bool darkMode)
+			{
+				QColor gradationColor;
+				if (control.freeRun)
+					gradationColor = QColor(0xE0, 0xFD, 0xE0);
+				else gradationColor = control.brake ? QColor(0xFD, 0xE0, 0xE0) : QColor(0xE0, 0xE0, 0xFD);
+
+				const QSize size(width, height);
+				const bool backgroundChanged = m_background.isNull() || m_size != size || m_darkMode != darkMode ||
+					m_gradationColor != gradationColor || m_titleFnt != titleFnt || m_valFnt != valFnt || m_valMiniFnt != valMiniFnt;
+				if (backgroundChanged)
+				{
+					m_size = size;
+					m_darkMode = darkMode;
+					m_gradationColor = gradationColor;
+					m_titleFnt = titleFnt;
+					m_valFnt = valFnt;
+					m_valMiniFnt = valMiniFnt;
+					renderBackground();
+				}
 
-		if (!finalShow)
-		{
-			painter.setBrush(textBrush);
-			drawTextAutoScale(QRectF(17 * xScale, 750 * yScale, image.width() - 34 * xScale, valFnt.pointSizeF()), control.masconOff ? QObject::tr("On") : QObject::tr("Off"), valFnt);
-		}
+				// Where each value goes this frame
+				const qreal xScale = static_cast<qreal>(width) / 500.0;
+				const qreal yScale = static_cast<qreal>(height) / 1080.0;
+				const auto valueRect = [&](qreal y, const QFont &font) { return QRectF(17 * xScale, y * yScale, width - 34 * xScale, font.pointSizeF()); };
+
+				std::array<Region, SlotCount> next;
+				next[PulseName0] = { valueRect(100, valFnt), {}, valFnt };
+				next[PulseName1] = { valueRect(170, valMiniFnt), {}, valMiniFnt };
+				next[PulseName2] = { valueRect(180, valMiniFnt), {}, valMiniFnt };
+				next[SineFreq] = { valueRect(323, valFnt), {}, valFnt };
+				next[SineAmplitude] = { valueRect(548, valFnt), {}, valFnt };
+				next[Freerun] = { valueRect(750, valFnt), {}, valFnt };
+				next[Brake] = { valueRect(930, valFnt), {}, valFnt };
+				if (!finalShow)
+				{
+					const QStringList pulseName = control.getPulseName();
+					next[PulseName0].text = pulseName[0];
+					if (pulseName.size() == 2)
+						next[PulseName1].text = pulseName[1];
+					else if (pulseName.size() >= 3)
+					{
+						next[PulseName1].rect = valueRect(160, valMiniFnt);
+						next[PulseName1].text = pulseName[1];
+						next[PulseName2].text = pulseName[2];
+					}
+					next[SineFreq].text = QString::number(control.videoSineFrequency, 'f', 2);
+					next[SineAmplitude].text = QString::number(control.videoSineAmplitude * 100, 'f', 2);
+					next[Freerun].text = control.masconOff ? QObject::tr("On") : QObject::tr("Off");
+					next[Brake].text = control.brake ? QObject::tr("On") : QObject::tr("Off");
+				}
 
-		// Draw Braking text
-		painter.setBrush(QColor(240, 240, 240));
-		painter.drawRect(QRectF(0, 847 * yScale, image.width(), 66 * yScale));
+				// Everything the old or the new text of a changed value covers
+				QRegion dirty;
+				for (size_t i = 0; i < next.size(); i++)
+				{
+					Region &region = next[i];
+					if (!region.text.isEmpty())
+					{
+						const QFont fitted = GenerateControlCommon::fitFont(region.text, region.font, region.rect.width());
+						region.font = fitted;
+						region.alignment = GenerateControlCommon::getAlignment(fitted.family()) | Qt::AlignTop;
+						// Padded for antialiasing and glyphs overhanging their advance
+						const QFontMetricsF metrics(fitted);
+						const int pad = int(metrics.height() / 4) + 2;
+						region.drawn = metrics.boundingRect(region.rect, region.alignment, region.text).toAlignedRect().adjusted(-pad, -pad, pad, pad);
+					}
+
+					const Region &previous = m_regions[i];
+					if (backgroundChanged || previous.text != region.text || previous.rect != region.rect || previous.font != region.font)
+						dirty = dirty.united(previous.drawn).united(region.drawn);
+				}
+				m_regions = next;
 
-		painter.setBrush(textBrush);
-		drawTextAutoScale(QRectF(17 * xScale, 852 * yScale, image.width() - 34 * xScale, titleFnt.pointSizeF()), QObject::tr("Brake"), titleFnt);
+				if (backgroundChanged)
+					m_frame = m_background.copy();
+				else if (dirty.isEmpty())
+					return m_frame;
 
-		painter.setBrush(QColorConstants::LightGray);
-		painter.drawRect(QRectF(0, 913 * yScale, image.width(), 8 * yScale));
+				QPainter painter(&m_frame);
+				if (!backgroundChanged)
+				{
+					painter.setClipRegion(dirty);
+					painter.setCompositionMode(QPainter::CompositionMode_Source);
+					painter.drawImage(0, 0, m_background);
+					painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+				}
+				for (size_t i = 0; i < m_regions.size(); i++)
+				{
+					const Region &region = m_regions[i];
+					if (region.text.isEmpty() || !dirty.intersects(region.drawn)) continue;
+					// The readouts that change nearly every frame are blitted from cached glyphs
+					if ((i == SineFreq || i == SineAmplitude) &&
+						GenerateControlCommon::drawDigits(painter, region.rect, region.text, region.font, region.alignment, painter.pen().color()))
+						continue;
+					painter.setFont(region.font);
+					painter.drawText(region.rect, region.alignment, region.text);
+				}
+				painter.end();
 
-		if (!finalShow)
-		{
-			painter.setBrush(textBrush);
-			drawTextAutoScale(QRectF(17 * xScale, 930 * yScale, image.width() - 34 * xScale, valFnt.pointSizeF()), control.brake ? QObject::tr("On") : QObject::tr("Off"), valFnt);
-		}
+				// Shared with the caller; the next frame detaches before painting
+				return m_frame;
+			}
+		};
+	}
 
-		return image;
+	QImage GenerateControlOriginal::getImage(
+		const VvvfValues &control,
+		bool finalShow,
+		int width,
+		int height,
+		const QFont &titleFnt,
+		const QFont &valFnt,
+		const QFont &valMiniFnt,
+		bool darkMode)
+	{
+		thread_local OriginalRenderer renderer;
+		return renderer.render(control, finalShow, width, height, titleFnt, valFnt, valMiniFnt, darkMode);
 	}
 
 	void GenerateControlOriginal::exportVideo(
@@ -171,21 +228,10 @@ namespace VvvfSimulator::Generation::Video::ControlInfo
 		const QFont &titleFnt,
 		const QFont &valFnt,
 		const QFont &valMiniFnt,
-		bool darkMode
+		bool darkMode,
+		bool headless
 	)
 	{
-		std::optional<VvvfSimulator::GUI::Util::BitmapViewer> viewer;
-		QMetaObject::invokeMethod(
-			QApplication::activeWindow(),
-			[&]()
-			{
-				viewer.emplace();
-			},
-			Qt::QueuedConnection
-		);
-		while (!viewer.has_value());
-		viewer->show();
-
 		const auto &vvvfData = generationBasicParameter.soundData;
 		const auto &masconData = generationBasicParameter.masconData;
 		auto progressData = generationBasicParameter.progress;
@@ -197,35 +243,24 @@ namespace VvvfSimulator::Generation::Video::ControlInfo
 			width,
 			height,
 			FPS,
-			AV_CODEC_ID_H264,
-			av::PixelFormat(AV_PIX_FMT_RGB32),
-			true
+			AV_CODEC_ID_H264
 		);
+		// Queued writes, the encoder keeps up alongside the frame pipeline
+		vr.setQueueCapacity(GenerationCommon::GenerationVideoWriter::defaultQueueCapacity);
+		vr.open();
 
 		// Generate Opening
 		{
 		}
 
-		bool loop = true, video_finished, final_show = false, first_show = true;
+		bool video_finished, final_show = false, first_show = true, first_frame = true;
 		double freeze_count = 0;
 
 		progressData.total = masconData.getEstimatedSteps((1.0 / FPS) + FPS * 2.0);
 
-		const auto getNextImage = [&]() { return getImage(control, final_show, width, height, titleFnt, valFnt, valMiniFnt, darkMode); };
-		QFuture<QImage> futureImage = QtConcurrent::run(getNextImage);
-
-		while (loop)
+		// Everything that happens after a frame is written, up to the next one
+		const auto advance = [&]()
 		{
-			control.sinTime = 0.0;
-			control.sawTime = 0.0;
-
-			const QImage currentImage = futureImage.result();
-			vr.writeFrame(currentImage);
-
-			viewer->setPixmap(QPixmap::fromImage(currentImage));
-
-			futureImage = QtConcurrent::run(getNextImage);
-
 			// PROGRESS ADD
 			progressData.progress++;
 
@@ -237,7 +272,7 @@ namespace VvvfSimulator::Generation::Video::ControlInfo
 					freeze_count = 0.0;
 					first_show = false;
 				}
-				continue;
+				return true;
 			}
 
 			video_finished = !masconData.checkForFreqChange(control, vvvfData, 1.0 / FPS);
@@ -246,10 +281,23 @@ namespace VvvfSimulator::Generation::Video::ControlInfo
 				final_show = true;
 				freeze_count++;
 			}
-			if (freeze_count > FPS || progressData.cancel) loop = false;
-		}
+			return !(freeze_count > FPS || progressData.cancel);
+		};
+
+		FramePipeline pipeline([&vr](const QImage &frame) { vr.writeFrame(frame); }, { headless, QSize(width, height) });
+		pipeline.run([&](FramePipeline::RenderJob &job)
+		{
+			if (!first_frame && !advance()) return false;
+			first_frame = false;
+
+			control.sinTime = 0.0;
+			control.sawTime = 0.0;
+			job = [control, final_show, width, height, titleFnt, valFnt, valMiniFnt, darkMode]()
+			{
+				return getImage(control, final_show, width, height, titleFnt, valFnt, valMiniFnt, darkMode);
+			};
+			return true;
+		});
 		vr.close();
-		
-		viewer->close();
 	}
 }
\ No newline at end of file
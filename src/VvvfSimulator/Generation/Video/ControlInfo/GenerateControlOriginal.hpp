@@ -20,7 +20,6 @@
 // Version 1.9.1.1
 
 // Internal
-#include "../../../GUI/Util/BitmapViewer.qml.hpp"
 #include "../../GenerateCommon.hpp"
 #include "../../../Vvvf/Struct.hpp"
 // Packages
@@ -52,6 +51,7 @@ namespace VvvfSimulator::Generation::Video::ControlInfo::GenerateControlOriginal
 		const QFont &titleFnt,
 		const QFont &valFnt,
 		const QFont &valMiniFnt,
-		bool darkMode = false
+		bool darkMode = false,
+		bool headless = false
 	);
 }
\ No newline at end of file
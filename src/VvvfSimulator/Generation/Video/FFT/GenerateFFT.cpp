@@ -1,15 +1,16 @@
 #include "GenerateFFT.hpp"
 
 // Standard Library
-#include <optional>
-#include <type_traits>
+#include <algorithm>
+#include <vector>
 // Internal
+#include "../FramePipeline.hpp"
+#include "../../../DSP/Spectral.hpp"
 #include "../../GenerateBasic.hpp"
 #include "../../QtVideoWriter.hpp"
 #include "../../../Yaml/MasconControl/YamlMasconAnalyze.hpp"
 // Packages
-#include <kissfft/kissfft.hh>
-#include <QApplication>
+#include <QFileInfo>
 #include <QFuture>
 #include <QPainter>
 #include <QPointF>
@@ -21,26 +22,46 @@ namespace VvvfSimulator::Generation::Video::FFT
 
 	QVector<std::complex<qreal>> GenerateFFT::FFTNAudio(const QVector<WaveValues> &waveForm)
 	{
-		static_assert(std::is_same<kissfft<qreal>::cpx_t, std::complex<qreal>>::value);
-		const auto &N = waveForm.size();
+		const auto plan = DSP::Spectral::getPlan(waveForm.size(), DSP::Spectral::WindowType::Hamming);
 
-		// Prepare input data for kissfft
-		const QVector<qreal> window = hammingWindow(N);
-		QVector<kissfft<qreal>::cpx_t> input(N); // let cpx_t = std::complex
-		for (qsizetype i = 0; i < N; i++) input[i] = std::complex<qreal>((waveForm[i].U - waveForm[i].V) * window[i], 0.0);
+		std::vector<double> input(waveForm.size());
+		for (qsizetype i = 0; i < waveForm.size(); i++) input[i] = waveForm[i].U - waveForm[i].V;
 
-		// Perform FFT using kissfft
-		kissfft<qreal> fft_obj(N, false);
-		QVector<std::complex<qreal>> fft(N);
-		fft_obj.transform(input.data(), fft.data());
+		QVector<std::complex<qreal>> fft(plan->binCount());
+		plan->windowAndTransform(input, std::span(fft.data(), fft.size()));
+		return fft;
+	}
+
+	const std::vector<std::complex<qreal>> &GenerateFFT::FFTNAudio(const GenerateBasic::WaveForm::EdgeList &waveForm)
+	{
+		const auto plan = DSP::Spectral::getPlan(waveForm.size(), DSP::Spectral::WindowType::Hamming);
+
+		// Reused by every frame this worker renders
+		thread_local std::vector<double> input;
+		thread_local std::vector<std::complex<qreal>> fft;
+		input.resize(waveForm.size());
+		fft.resize(plan->binCount());
+
+		for (size_t k = 0; k < waveForm.edges.size(); k++)
+		{
+			const auto &edge = waveForm.edges[k];
+			std::fill_n(input.begin() + edge.index, waveForm.runLength(k), static_cast<double>(edge.state.U - edge.state.V));
+		}
+		plan->windowAndTransform(input, fft);
 
 		return fft;
 	}
+
 	QImage GenerateFFT::getImage(VvvfValues control, const YamlVvvfSoundData &sound, const QSize &size, bool darkMode)
 	{
 			control.allowRandomFreqMove = false;
-			QVector<WaveValues> PWM_Array = VvvfSimulator::Generation::GenerateBasic::WaveForm::getUVWSec(control, sound, m_PI_6, std::pow(2, Pow) - 1, false);
-			QVector<std::complex<qreal>> FFT = FFTNAudio(PWM_Array);
+			// Same one-second sampling as getUVWSec(..., 2^Pow - 1, false), without the dense array
+			control.generationCurrentTime = 0;
+			control.sinTime = 0;
+			control.sawTime = 0;
+			constexpr qsizetype count = (qsizetype(1) << Pow) - 1;
+			const auto PWM_Edges = VvvfSimulator::Generation::GenerateBasic::WaveForm::getUVWEdges(control, sound, m_PI_6, static_cast<double>(count), count);
+			const std::vector<std::complex<qreal>> &FFT = FFTNAudio(PWM_Edges);
 
 			QImage image(size, QImage::Format_RGB32);
 			QPainter painter(&image);
@@ -52,11 +73,20 @@ namespace VvvfSimulator::Generation::Video::FFT
 
 			const auto &width = size.width(), &height = size.height();
 
+			// FFT only holds bins 0 to count / 2; the others are their complex
+			// conjugates (and the spectrum repeats every count bins), so wide
+			// images still get the full-spectrum magnitudes.
+			const auto magnitude = [&FFT](qsizetype k)
+			{
+				k %= count;
+				return std::abs(FFT[static_cast<size_t>(std::min(k, count - k))]);
+			};
+
 			for (int i = 0; i < width - 1; i++)
 			{
 				const auto Rindex = static_cast<qsizetype>(m_PI * i);
-				const qreal Ri = std::abs(FFT[Rindex]);
-				const qreal Rii = std::abs(FFT[Rindex + 1]);
+				const qreal Ri = magnitude(Rindex);
+				const qreal Rii = magnitude(Rindex + 1);
 				const QPointF start(i, height - Ri * static_cast<qreal>(static_cast<int64_t>(height) * 2));
 				const QPointF end(i + 1, height - Rii * static_cast<qreal>(static_cast<int64_t>(height) * 2));
 				painter.drawLine(start, end);
@@ -72,25 +102,14 @@ namespace VvvfSimulator::Generation::Video::FFT
 		AVCodecID codecID,
 		bool darkMode,
 		bool startWait,
-		bool endWait)
+		bool endWait,
+		bool headless)
 	{
 		using GenerationVideoWriter = VvvfSimulator::Generation::GenerationCommon::GenerationVideoWriter;
 		using ProgressData = VvvfSimulator::Generation::GenerationCommon::GenerationBasicParameter::ProgressData;
 		using YamlMasconDataCompiled = NAMESPACE_YAMLMASCONCONTROL::YamlMasconAnalyze::YamlMasconDataCompiled;
 		using YamlVvvfSoundData = NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData;
 		
-		std::optional<BitmapViewer> viewer(std::nullopt);
-		QMetaObject::invokeMethod(
-			QApplication::activeWindow(),
-			[&]()
-			{
-				viewer.emplace(QPixmap(), QObject::tr("Bitmap Viewer"), size, true);
-			},
-			Qt::QueuedConnection
-		);
-		while (!viewer.has_value());
-		//viewer->show();
-
 		const YamlVvvfSoundData &vvvfData = parameter.soundData;
 		const YamlMasconDataCompiled &masconData = parameter.masconData;
 		ProgressData progressData = parameter.progress;
@@ -99,7 +118,10 @@ namespace VvvfSimulator::Generation::Video::FFT
 		
 		control.allowRandomFreqMove = false;
 
-		GenerationVideoWriter vr(fileName, size.width(), size.height(), fps, codecID, av::PixelFormat(AV_PIX_FMT_RGB24), true);
+		GenerationVideoWriter vr(fileName, size.width(), size.height(), fps, codecID);
+		// Encode on the writer's own thread so rendering doesn't wait on it
+		vr.setQueueCapacity(GenerationVideoWriter::defaultQueueCapacity);
+		vr.open();
 
 		// No longer really necessary because the opening will throw if it fails
 		//if (!vr.isOpen()) return;
@@ -113,58 +135,30 @@ namespace VvvfSimulator::Generation::Video::FFT
 		// PROGRESS CHANGE
 		progressData.progress += fps;
 
-		bool loop = true;
-		QImage currentImage;
-		const auto getNextImage = [&]() { return getImage(control, vvvfData, size, darkMode); };
-    QFuture<QImage> futureImage = QtConcurrent::run(getNextImage);
+		FramePipeline pipeline([&vr](const QImage &frame) { vr.writeFrame(frame); }, { headless, size });
+		bool firstFrame = true;
+		pipeline.run([&](FramePipeline::RenderJob &job)
+		{
+			if (!firstFrame && (progressData.cancel || !masconData.checkForFreqChange(control, vvvfData, 1.0 / fps)))
+				return false;
+			firstFrame = false;
 
-    while (loop)
-    {
 			control.sinTime = 0.0;
 			control.sawTime = 0.0;
-
-			currentImage = futureImage.result();
-			vr.writeFrame(currentImage);
-
-			viewer->setPixmap(QPixmap::fromImage(currentImage));
-
-			futureImage = QtConcurrent::run(getNextImage);
-
-			//viewer->setImage(currentImage);
-
-			if (progressData.cancel) loop = false;
-			else loop = masconData.checkForFreqChange(control, vvvfData, 1.0 / fps);
+			job = [control, &vvvfData, size, darkMode]() { return getImage(control, vvvfData, size, darkMode); };
 
 			// PROGRESS CHANGE
 			progressData.progress++;
-    }
+			return true;
+		});
 
 		const bool &END_WAIT = endWait;
 		if (END_WAIT) vr.addEmptyFrames(fps, darkMode);
 
 		vr.close();
-
-		viewer->close();
 	}
-	void GenerateFFT::exportImage(const QDir &fileName, const YamlVvvfSoundData &soundData, double d, const QSize &size, bool darkMode, const char* exportFormat, QImage* output)
+	void GenerateFFT::exportImage(const QDir &fileName, const YamlVvvfSoundData &soundData, double d, const QSize &size, bool darkMode, const char* exportFormat, QImage* output, bool headless)
 	{
-		using GenerationVideoWriter = VvvfSimulator::Generation::GenerationCommon::GenerationVideoWriter;
-		using ProgressData = VvvfSimulator::Generation::GenerationCommon::GenerationBasicParameter::ProgressData;
-		using YamlMasconDataCompiled = NAMESPACE_YAMLMASCONCONTROL::YamlMasconAnalyze::YamlMasconDataCompiled;
-		using YamlVvvfSoundData = NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData;
-		
-		std::optional<BitmapViewer> viewer(std::nullopt);
-		QMetaObject::invokeMethod(
-			QApplication::activeWindow(),
-			[&]()
-			{
-				viewer.emplace(QPixmap(), QObject::tr("Bitmap Viewer"), size, true);
-			},
-			Qt::QueuedConnection
-		);
-		while (!viewer.has_value());
-		viewer->show();
-
 		VvvfValues control;
 		
 		control.allowRandomFreqMove = false;
@@ -173,16 +167,16 @@ namespace VvvfSimulator::Generation::Video::FFT
 		control.controlFrequency = d;
 
 		const QImage image = getImage(control, soundData, size, darkMode);
-		viewer->setPixmap(QPixmap::fromImage(image));
 		image.save(fileName.absolutePath(), exportFormat);
 		if (output) *output = image;
+		if (headless) return;
 
-    // Extract the file name and append it to the viewer's title
-    const QFileInfo fileInfo(fileName.absolutePath());
-    const QString fileNameWithExtension = fileInfo.fileName();
-    viewer->setWindowTitle(viewer->windowTitle() + " - " + fileNameWithExtension);
+		// Append the file name to the viewer's title
+		const QFileInfo fileInfo(fileName.absolutePath());
+		FramePreview preview(size, QObject::tr("Bitmap Viewer") + " - " + fileInfo.fileName());
+		preview.post(image);
 
 		// Wait for window to close
-		while (viewer->isVisible()) QApplication::processEvents();
+		preview.waitUntilClosed();
 	}
 }
\ No newline at end of file
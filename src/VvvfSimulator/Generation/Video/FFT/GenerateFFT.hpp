@@ -4,9 +4,11 @@
 #include <complex>
 #include <memory>
 //#include <pair>
+#include <vector>
 #include <type_traits>
 // Internal
 #include "../../../GUI/Util/BitmapViewer.qml.hpp"
+#include "../../GenerateBasic.hpp"
 #include "../../GenerateCommon.hpp"
 #include "../../../Vvvf/InternalMath.hpp"
 #include "../../../Vvvf/Struct.hpp"
@@ -30,16 +32,18 @@ namespace VvvfSimulator::Generation::Video::FFT
 	class GenerateFFT
 	{
 		static constexpr int Pow = 15;
-		static inline QVector<qreal> hammingWindow(qsizetype N)
-		{
-			QVector<qreal> window(N);
-			if constexpr (std::is_same<qreal, double>())
-				for (int n = 0; n < N; ++n) window[n] = 0.54 - 0.46 * NAMESPACE_VVVF::InternalMath::Functions::cosine(2.0 * M_PI * n / (N - 1));
-			else
-				for (int n = 0; n < N; ++n) window[n] = 0.54 - 0.46 * std::cos(2.0 * M_PI * n / (N - 1));
-			return window;
-		}		
+		static_assert(std::is_same_v<qreal, double>, "DSP::Spectral works in double precision");
+
+		/// <summary>
+		/// Hamming-windowed spectrum of the U-V voltage, bins 0 to N / 2.
+		/// </summary>
 		static QVector<std::complex<qreal>> FFTNAudio(const QVector<WaveValues>& waveForm);
+		/// <summary>
+		/// Same for waveForm.toDense(), filled run by run through the shared
+		/// DSP::Spectral plan for its size. The result lives in a per-thread
+		/// buffer, valid until the next call on the same thread.
+		/// </summary>
+		static const std::vector<std::complex<qreal>>& FFTNAudio(const GenerateBasic::WaveForm::EdgeList& waveForm);
 
 		//std::shared_ptr<BitmapViewer> m_viewer = nullptr;
 
@@ -63,7 +67,8 @@ namespace VvvfSimulator::Generation::Video::FFT
 			AVCodecID codecID = AV_CODEC_ID_H264,
 			bool darkMode = false,
 			bool startWait = true,
-			bool endWait = true);
+			bool endWait = true,
+			bool headless = false);
 		void exportImage(
 			const QDir &fileName,
 			const YamlVvvfSoundData &soundData,
@@ -72,6 +77,7 @@ namespace VvvfSimulator::Generation::Video::FFT
 			//const QImage::Format &format = Format_RGB888,
 			bool darkMode = false,
 			const char* exportFormat = nullptr,
-			QImage* output = nullptr);
+			QImage* output = nullptr,
+			bool headless = false);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "FramePipeline.hpp"
+// Standard Library
+#include <algorithm>
+#include <deque>
+#include <utility>
+// Packages
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QFuture>
+#include <QGuiApplication>
+#include <QMetaObject>
+#include <QPixmap>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+namespace VvvfSimulator::Generation::Video
+{
+	using GUI::Util::BitmapViewer;
+
+	namespace
+	{
+		/// Runs f on the GUI thread and blocks (without polling) until it returns
+		template <typename F>
+		void runOnGuiThread(F &&f)
+		{
+			QCoreApplication *app = QCoreApplication::instance();
+			if (QThread::currentThread() == app->thread()) f();
+			else QMetaObject::invokeMethod(app, std::forward<F>(f), Qt::BlockingQueuedConnection);
+		}
+	}
+
+	bool FramePreview::isAvailable()
+	{
+		return qobject_cast<QGuiApplication *>(QCoreApplication::instance()) != nullptr;
+	}
+
+	FramePreview::FramePreview(const QSize &size, const QString &title, bool show)
+		: m_pending(std::make_shared<Pending>())
+	{
+		if (!isAvailable()) return;
+		runOnGuiThread([this, &size, &title, show]()
+		{
+			m_viewer = new BitmapViewer(QPixmap(), title, size, show);
+		});
+	}
+
+	FramePreview::~FramePreview()
+	{
+		if (!m_viewer) return;
+		QMetaObject::invokeMethod(m_viewer, [viewer = m_viewer]()
+		{
+			viewer->close();
+			viewer->deleteLater();
+		}, Qt::QueuedConnection);
+	}
+
+	void FramePreview::post(const QImage &image)
+	{
+		if (!m_viewer) return;
+		{
+			std::lock_guard lock(m_pending->mutex);
+			m_pending->image = image; // Implicitly shared, not copied
+			if (m_pending->queued) return;
+			m_pending->queued = true;
+		}
+		QMetaObject::invokeMethod(m_viewer, [viewer = m_viewer, pending = m_pending]()
+		{
+			QImage latest;
+			{
+				std::lock_guard lock(pending->mutex);
+				std::swap(latest, pending->image);
+				pending->queued = false;
+			}
+			viewer->setPixmap(QPixmap::fromImage(latest));
+		}, Qt::QueuedConnection);
+	}
+
+	void FramePreview::waitUntilClosed()
+	{
+		if (!m_viewer) return;
+
+		QEventLoop loop;
+		QObject::connect(m_viewer, &BitmapViewer::isVisibleChanged, &loop, [&loop](bool visible)
+		{
+			if (!visible) loop.quit();
+		}, Qt::QueuedConnection);
+
+		// Connected first, so a close right after this check still ends the loop
+		bool visible = false;
+		runOnGuiThread([this, &visible]() { visible = m_viewer->isVisible(); });
+		if (visible) loop.exec();
+	}
+
+	FramePipeline::FramePipeline(EncodeStage encode, const Options &options)
+		: m_encode(std::move(encode))
+		, m_framesInFlight(options.framesInFlight > 0
+			? options.framesInFlight
+			: std::max(2, QThreadPool::globalInstance()->maxThreadCount()))
+	{
+		if (!options.headless && FramePreview::isAvailable())
+			m_preview = std::make_unique<FramePreview>(options.previewSize, options.previewTitle);
+	}
+
+	qsizetype FramePipeline::run(const ComputeStage &compute)
+	{
+		std::deque<QFuture<QImage>> inFlight;
+		bool more = true;
+		const auto refill = [&]()
+		{
+			while (more && static_cast<qsizetype>(inFlight.size()) < m_framesInFlight)
+			{
+				RenderJob job;
+				more = compute(job);
+				if (more) inFlight.push_back(QtConcurrent::run(std::move(job)));
+			}
+		};
+
+		qsizetype frames = 0;
+		refill();
+		while (!inFlight.empty())
+		{
+			const QImage frame = inFlight.front().result();
+			inFlight.pop_front();
+			// Top the pool up before encoding, so it never idles behind the encoder
+			refill();
+
+			m_encode(frame);
+			if (m_preview) m_preview->post(frame);
+			frames++;
+		}
+		return frames;
+	}
+}
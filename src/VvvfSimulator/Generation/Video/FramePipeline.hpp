@@ -0,0 +1,99 @@
+#pragma once
+
+// Standard Library
+#include <functional>
+#include <memory>
+#include <mutex>
+// Packages
+#include <QImage>
+#include <QObject>
+#include <QSize>
+#include <QString>
+#include <QtGlobal>
+// Internal
+#include "../../GUI/Util/BitmapViewer.qml.hpp"
+
+namespace VvvfSimulator::Generation::Video
+{
+	/*
+	@brief Live preview of exported frames in a BitmapViewer living on the GUI
+	thread. Creating it waits for the GUI thread without spinning, and frames
+	are posted rather than waited for: while one is still queued, newer ones
+	replace it instead of piling up behind a busy event loop.
+	*/
+	class FramePreview
+	{
+		struct Pending
+		{
+			std::mutex mutex;
+			QImage image;
+			bool queued = false;
+		};
+
+		GUI::Util::BitmapViewer *m_viewer = nullptr;
+		std::shared_ptr<Pending> m_pending;
+
+	public:
+		/// False without a QGuiApplication, e.g. in command line renders
+		static bool isAvailable();
+
+		/*
+		@brief Opens the viewer, unless isAvailable() is false, in which case
+		every other member does nothing.
+		*/
+		explicit FramePreview(const QSize &size, const QString &title = QObject::tr("Bitmap Viewer"), bool show = true);
+		/// Closes the viewer and deletes it on the GUI thread
+		~FramePreview();
+
+		FramePreview(const FramePreview &) = delete;
+		FramePreview &operator=(const FramePreview &) = delete;
+
+		bool isOpen() const noexcept { return m_viewer != nullptr; }
+		void post(const QImage &image);
+		/// Runs a local event loop (no polling) until the user closes the viewer
+		void waitUntilClosed();
+	};
+
+	/*
+	@brief Frame export loop split into stages:
+	compute (calling thread, in order) -> render (global thread pool) ->
+	encode (calling thread, in order) -> preview (GUI thread, latest frame).
+
+	The compute stage advances the simulation and hands back a render job that
+	owns a snapshot of whatever it draws, so up to Options::framesInFlight
+	frames render at once while earlier ones are encoded, without sharing
+	mutable state. Frames reach the encoder in the order they were computed.
+	*/
+	class FramePipeline
+	{
+	public:
+		using RenderJob = std::function<QImage()>;
+		/// Sets job to the next frame's rendering; false once there are no more frames
+		using ComputeStage = std::function<bool(RenderJob &job)>;
+		using EncodeStage = std::function<void(const QImage &frame)>;
+
+		struct Options
+		{
+			/// Never opens the preview, e.g. for batch renders on a server
+			bool headless = false;
+			QSize previewSize = QSize(1000, 1000);
+			QString previewTitle = QObject::tr("Bitmap Viewer");
+			/// Frames rendering at once; 0 picks the global pool size (at least 2)
+			int framesInFlight = 0;
+		};
+
+		FramePipeline(EncodeStage encode, const Options &options);
+
+		/*
+		@returns How many frames were encoded.
+		*/
+		qsizetype run(const ComputeStage &compute);
+
+		FramePreview *preview() noexcept { return m_preview.get(); }
+
+	private:
+		EncodeStage m_encode;
+		std::unique_ptr<FramePreview> m_preview;
+		qsizetype m_framesInFlight;
+	};
+}
@@ -20,78 +20,77 @@
 // Version 1.9.1.1
 
 // Standard Library
-#include <cfloat>
+#include <vector>
 // Packages
 #include <QPainter>
+#include <QPolygonF>
 // Internal
 #include "../../GenerateBasic.hpp"
+#include "../../../Vvvf/SIMD/TrajectorySimd.hpp"
 
 namespace VvvfSimulator::Generation::Video::ControlInfo::GenerateHexagonOriginal
 {
 	QImage getImage(const QVector<WaveValues> &UVW, double controlFrequency, const QSize &size, qreal thickness, bool zeroVectorCircle, bool darkMode)
+	{
+		return getImage(GenerateBasic::WaveForm::EdgeList::fromDense(UVW), controlFrequency, size, thickness, zeroVectorCircle, darkMode);
+	}
+
+	QImage getImage(const EdgeList &UVW, double controlFrequency, const QSize &size, qreal thickness, bool zeroVectorCircle, bool darkMode)
 	{
 		QImage imResult(size, QImage::Format_RGB32);
 		imResult.fill(darkMode ? QColorConstants::Black : QColorConstants::White);
 		if (controlFrequency == 0.0) return imResult;
 
-		bool drawnCircle = false;
-		QPointF currentPoint(0.0, 0.0),
-		        maxValue(DBL_MIN, DBL_MIN),
-						minValue(DBL_MAX, DBL_MAX);
-		QVector<QPointF> zeroPoints, linePoints{ currentPoint };
-
-		WaveValues preWaveValues(0, 0, 0);
+		// Structure of arrays for the kernel, kept per thread between frames
+		thread_local std::vector<double> u, v, w, weight, alpha, beta;
+		const size_t runs = UVW.edges.size();
+		for (auto *buffer : { &u, &v, &w, &weight, &alpha, &beta }) buffer->resize(runs);
 
-		for (const auto &value : UVW)
+		// Zero vectors get a circle where they start, once per stretch of them
+		QVector<size_t> zeroRuns;
+		bool drawnCircle = false;
+		for (size_t k = 0; k < runs; k++)
 		{
-			QPointF deltaMove(
-				-0.5 * value.W - 0.5 * value.V + value.U,
-				-0.866025403784438646763 * value.W + 0.866025403784438646763 * value.V
-			);
-
-			if (preWaveValues != value)
-			{
-				linePoints.emplace_back(currentPoint);
-				preWaveValues = value;
-			}
-
-			if (deltaMove.isNull() && zeroVectorCircle && !drawnCircle)
+			const WaveValues &value = UVW.edges[k].state;
+			u[k] = value.U;
+			v[k] = value.V;
+			w[k] = value.W;
+			weight[k] = static_cast<double>(UVW.runLength(k));
+
+			const bool isZero = value.U == value.V && value.V == value.W;
+			if (isZero && zeroVectorCircle && !drawnCircle)
 			{
 				drawnCircle = true;
-				zeroPoints.emplace_back(currentPoint);
+				zeroRuns.emplace_back(k);
 			}
-			else if (!deltaMove.isNull()) drawnCircle = false;
-			currentPoint += deltaMove;
-
-			maxValue = QPointF(
-				qMax(maxValue.x(), currentPoint.x()),
-				qMax(maxValue.y(), currentPoint.y())
-			);
-			minValue = QPointF(
-				qMin(minValue.x(), currentPoint.x()),
-				qMin(minValue.y(), currentPoint.y())
-			);
+			else if (!isZero) drawnCircle = false;
 		}
 
-		QPainter pResult(&imResult);
-		const double k = 1200.00 / (UVW.size() - 1);
+		// Each run of constant state moves the point in a straight line, so the
+		// trajectory is the prefix sum of the runs' Clarke vectors (scaled by 3/2,
+		// one unit per phase step), and only its corners can be extremes.
+		const auto bounds = Vvvf::InternalMath::Functions::SIMD::clarkeTrajectory(u, v, w, weight, 1.5, alpha, beta);
+		const QPointF minValue(bounds.minAlpha, bounds.minBeta), maxValue(bounds.maxAlpha, bounds.maxBeta);
 
+		const double k = 1200.00 / (UVW.size() - 1);
 		const QPointF correctionAmount(
 			0.5 * size.width() - k * (minValue.x() + (maxValue.x() - minValue.x()) * 0.5),
 			0.5 * size.height() - k * (minValue.y() + (maxValue.y() - minValue.y()) * 0.5)
 		);
 
+		// Corner i + 1 is where run i ends
+		QPolygonF linePoints(static_cast<qsizetype>(runs) + 1);
+		linePoints[0] = correctionAmount;
+		for (size_t i = 0; i < runs; i++)
+			linePoints[static_cast<qsizetype>(i) + 1] = QPointF(k * alpha[i] + correctionAmount.x(), k * beta[i] + correctionAmount.y());
+
+		QPainter pResult(&imResult);
 		pResult.setPen(QPen(darkMode ? QColorConstants::White : QColorConstants::Black, thickness));
-		for (auto point = linePoints.begin(); point + 1 != linePoints.end(); point++)
-		{
-			const QPointF start(k * (*point) + correctionAmount),
-			              end(k * (*(point + 1)) + correctionAmount);
-			pResult.drawLine(start, end);
-		}
+		pResult.drawPolyline(linePoints);
 
-		for (const auto &_point : zeroPoints)
+		for (const size_t run : zeroRuns)
 		{
-			const QPointF point(k * _point + correctionAmount);
+			const QPointF &point = linePoints[static_cast<qsizetype>(run)];
 
 			const double radius = 15.0 * ((controlFrequency > 40) ? 1 : (controlFrequency / 40.0));
 			// Fill the ellipse
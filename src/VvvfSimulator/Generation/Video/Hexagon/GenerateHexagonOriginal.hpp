@@ -20,6 +20,7 @@
 // Version 1.9.1.1
 
 // Internal
+#include "../../GenerateBasic.hpp"
 #include "../../GenerateCommon.hpp"
 #include "../../../Vvvf/InternalMath.hpp"
 #include "../../../Vvvf/Struct.hpp"
@@ -36,8 +37,31 @@ namespace VvvfSimulator::Generation::Video::ControlInfo::GenerateHexagonOriginal
 {
 	using NAMESPACE_VVVF::Struct::VvvfValues;
 	using NAMESPACE_VVVF::Struct::WaveValues;
+	using GenerateBasic::WaveForm::EdgeList;
 	using NAMESPACE_YAMLVVVFSOUND::YamlVvvfSoundData;
 	
+	QImage getImage(
+		const QVector<WaveValues> &UVW,
+		double controlFrequency,
+		const QSize &size,
+		qreal thickness,
+		bool zeroVectorCircle,
+		bool darkMode = false
+	);
+
+	/// <summary>
+	/// Same image from the run-length form; walks the switching events
+	/// instead of every sample.
+	/// </summary>
+	QImage getImage(
+		const EdgeList &UVW,
+		double controlFrequency,
+		const QSize &size,
+		qreal thickness,
+		bool zeroVectorCircle,
+		bool darkMode = false
+	);
+
 	/// <summary>
 	/// Gets image of Voltage Vector Hexagon
 	/// </summary>
@@ -61,20 +85,11 @@ namespace VvvfSimulator::Generation::Video::ControlInfo::GenerateHexagonOriginal
 		bool darkMode = false
 	)
 	{
-		const auto PWM_Array = GenerateBasic::WaveForm::getUVWCycle(control, sound, 0.0, delta, preciseDelta);
+		const auto PWM_Array = GenerateBasic::WaveForm::getUVWCycleEdges(control, sound, 0.0, delta, preciseDelta);
 
 		return getImage(PWM_Array, control.controlFrequency, size, thickness, zeroVectorCircle, darkMode);
 	}
 
-	QImage getImage(
-		const QVector<WaveValues> &UVW,
-		double controlFrequency,
-		const QSize &size,
-		int thickness,
-		bool zeroVectorCircle,
-		bool darkMode = false
-	);
-
 	void exportVideo(
 		GenerationCommon::GenerationBasicParameter &generationBasicParameter,
 		const QDir &fileName,
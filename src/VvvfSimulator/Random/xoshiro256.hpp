@@ -22,9 +22,50 @@
 // Standard Library Includes
 #include <array>
 #include <cinttypes>
+#include <cstddef>
+#include <cstdint>
 
 namespace VvvfSimulator::Random
 {
+	/// SplitMix64 finalizer; a bijective 64-bit mix
+	constexpr uint64_t splitmix64Mix(uint64_t z) noexcept
+	{
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9uLL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebuLL;
+		return z ^ (z >> 31);
+	}
+
+	/// Maps 64 random bits to a double uniformly distributed in [0, 1)
+	constexpr double toUnitDouble(uint64_t x) noexcept
+	{
+		return static_cast<double>(x >> 11) * 0x1.0p-53;
+	}
+
+	/*
+	Counter-based random stream: value i is a pure function of (seed, i), so
+	any element can be drawn directly, in any order and from any thread.
+	Element i equals the (i + 1)-th output of a sequential SplitMix64
+	generator seeded with seed.
+	*/
+	class CounterStream
+	{
+		uint64_t m_seed;
+
+	public:
+		static constexpr uint64_t increment = 0x9e3779b97f4a7c15uLL;
+
+		constexpr CounterStream(uint64_t seed = 0) noexcept : m_seed(seed) {}
+
+		constexpr uint64_t seed() const noexcept { return m_seed; }
+		constexpr uint64_t at(uint64_t counter) const noexcept
+		{
+			return splitmix64Mix(m_seed + (counter + 1) * increment);
+		}
+		constexpr uint64_t operator[](uint64_t counter) const noexcept { return at(counter); }
+		/// Element counter as a double in [0, 1)
+		constexpr double unitAt(uint64_t counter) const noexcept { return toUnitDouble(at(counter)); }
+	};
+
 	class xoshiro256ss
 	{
 		std::array<uint64_t, 4> s;
@@ -32,18 +73,33 @@ namespace VvvfSimulator::Random
 
 		static constexpr uint64_t splitmix64(uint64_t x)
 		{
-			uint64_t z = (x += 0x9e3779b97f4a7c15uLL);
-			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9uLL;
-			z = (z ^ (z >> 27)) * 0x94d049bb133111ebuLL;
-			return z ^ (z >> 31);
+			return splitmix64Mix(x + CounterStream::increment);
 		}
 
 		static constexpr uint64_t rotl(uint64_t x, int k)
 		{
 			return (x << k) | (x >> (64 - k));
 		}
+
+		constexpr void jumpWith(const std::array<uint64_t, 4> &polynomial)
+		{
+			std::array<uint64_t, 4> t{};
+			for (const uint64_t word : polynomial)
+				for (int b = 0; b < 64; b++)
+				{
+					if (word & (uint64_t(1) << b))
+						for (size_t i = 0; i < t.size(); i++) t[i] ^= s[i];
+					operator()();
+				}
+			s = t;
+		}
 		
 	public:
+		// UniformRandomBitGenerator
+		using result_type = uint64_t;
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT64_MAX; }
+
 		static constexpr uint64_t defaultSeed = 0;
 	
 		//constexpr xoshiro256ss() { *this = xoshiro256ss(defaultSeed); }
@@ -74,5 +130,23 @@ namespace VvvfSimulator::Random
 			for (auto& state : s)
 				state = stateValue;
 		}
+		constexpr uint64_t seed() const noexcept { return m_seed; }
+
+		/*
+		Advances the state by 2^128 calls to next(); used to split the sequence
+		into 2^128 non-overlapping subsequences, e.g. one per thread.
+		*/
+		constexpr void jump()
+		{
+			jumpWith({0x180ec6d33cfd0abauLL, 0xd5a61266f0c9392cuLL, 0xa9582618e03fc9aauLL, 0x39abdc4529b1661cuLL});
+		}
+		/*
+		Advances the state by 2^192 calls to next(); yields 2^64 starting points,
+		each of which can be split further with jump().
+		*/
+		constexpr void long_jump()
+		{
+			jumpWith({0x76e15d3efefdcbbfuLL, 0xc5004e441c522fb3uLL, 0x77710069854ee241uLL, 0x39109bb02acbe635uLL});
+		}
 	};
 }
\ No newline at end of file
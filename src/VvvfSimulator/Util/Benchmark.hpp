@@ -0,0 +1,51 @@
+#pragma once
+
+// Standard Library
+#include <concepts>
+#include <type_traits>
+// Packages
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+namespace VvvfSimulator::Util::Benchmark
+{
+	/*
+	@brief Before/after throughput of one code path, in items per second.
+	*/
+	struct Throughput
+	{
+		qsizetype items = 0;
+		double beforeRate = 0.0;
+		double afterRate = 0.0;
+
+		constexpr double speedup() const noexcept
+		{
+			return beforeRate > 0.0 ? afterRate / beforeRate : 0.0;
+		}
+	};
+
+	/*
+	@brief Times body, which returns how many items it processed.
+	@returns Items per second, 0 if the timer did not advance.
+	*/
+	template <typename Body>
+		requires std::convertible_to<std::invoke_result_t<Body>, qsizetype>
+	double measureRate(Body &&body, qsizetype *items = nullptr)
+	{
+		QElapsedTimer timer;
+		timer.start();
+		const qsizetype count = body();
+		const qint64 elapsed = timer.nsecsElapsed();
+		if (items) *items = count;
+		return elapsed > 0 ? count * 1e9 / elapsed : 0.0;
+	}
+
+	/// Logs (qInfo) a Throughput as "<what> over <n> items: <before> /s <beforeLabel>, <after> /s <afterLabel> (<x>x)"
+	inline void report(const char *what, const Throughput &result, const char *beforeLabel, const char *afterLabel)
+	{
+		qInfo().nospace() << what << " over " << result.items << " items: "
+			<< result.beforeRate << " /s " << beforeLabel << ", "
+			<< result.afterRate << " /s " << afterLabel << " (" << result.speedup() << "x)";
+	}
+}
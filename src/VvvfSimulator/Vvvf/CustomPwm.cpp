@@ -20,18 +20,78 @@
 #include "CustomPwm.hpp"
 // Standard Library
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
 #include <cmath>
 #include <cstring>
 #include <fstream>
+#include <limits>
+#include <mutex>
 // Packages
+#include <xsimd.hpp>
+#include <QByteArray>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QFile>
+#include <QFuture>
 #include <QHash>
+#include <QList>
+#include <QResource>
+#include <QSaveFile>
 #include <QStringView>
+#include <QtConcurrent/QtConcurrent>
 
 namespace VvvfSimulator::Vvvf::CustomPwm
 {
+	namespace {
+		/// Split a phase angle into its quarter-wave orthant (0 - 3) and the
+		/// position inside it in quarter-wave units (0 - 1), mirrored for odd
+		/// orthants so it can be compared against the first quarter's angles.
+		inline double normalizeQuarterWave(double X, int& orthant)
+		{
+			const double q = X * InternalMath::m_2_PI;
+			const double whole = std::floor(q);
+			orthant = static_cast<int>(static_cast<int64_t>(whole) & 0x03);
+			const double position = q - whole;
+			return (orthant & 0x01) ? 1.0 - position : position;
+		}
+
+		/// Backing storage of tables parsed from the original .bin format
+		struct OwnedArrays
+		{
+			std::vector<double> angles;
+			std::vector<uint8_t> outputs;
+			std::vector<uint8_t> startLevels;
+		};
+
+		bool hasMappedMagic(const void* data, size_t size)
+		{
+			return size >= sizeof(MappedTableHeader::MAGIC) &&
+				memcmp(data, MappedTableHeader::MAGIC, sizeof(MappedTableHeader::MAGIC)) == 0;
+		}
+
+		constexpr size_t alignUp(size_t value, size_t alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		/// Whether every block's switch angles ascend and its padding sorts after
+		/// any quarter-wave position (0 - 1), which lookup() relies on: it counts
+		/// the angles at or before the position instead of searching for it.
+		bool hasAscendingAngles(const double* angles, uint32_t blockCount, size_t stride, uint8_t switchCount)
+		{
+			for (size_t block = 0; block < blockCount; ++block) {
+				const double* row = angles + block * stride;
+				for (size_t j = 1; j < switchCount; ++j)
+					if (!(row[j - 1] <= row[j])) return false; // Also rejects NaN
+				for (size_t j = switchCount; j < stride; ++j)
+					if (!(row[j] > 1.0)) return false;
+			}
+			return true;
+		}
+	} // namespace
+
 	// ===== CustomPwmTable Implementation =====
 
 	CustomPwmTable::CustomPwmTable(const uint8_t* data, size_t size)
@@ -57,39 +117,161 @@ namespace VvvfSimulator::Vvvf::CustomPwm
 		memcpy(&blockCount, data + offset, sizeof(uint32_t));
 		offset += sizeof(uint32_t);
 
-		// Read blocks
-		blocks.resize(blockCount);
+		// Read blocks into the flat arrays; padding angles never compare <= X
+		stride = alignUp(switchCount, STRIDE_ALIGNMENT);
+		auto storage = std::make_shared<OwnedArrays>();
+		storage->angles.assign(size_t(blockCount) * stride, std::numeric_limits<double>::infinity());
+		storage->outputs.assign(size_t(blockCount) * stride, 0);
+		storage->startLevels.assign(blockCount, 0);
 		for (uint32_t i = 0; i < blockCount; ++i) {
 			if (offset >= size) break;
 
-			ModulationBlock& block = blocks[i];
-			block.startLevel = data[offset++];
-			block.switchAngles.resize(switchCount);
+			storage->startLevels[i] = data[offset++];
 
 			for (uint8_t j = 0; j < switchCount; ++j) {
 				if (offset + sizeof(uint8_t) + sizeof(double) > size) break;
 
-				SwitchAngle& sa = block.switchAngles[j];
-				sa.output = data[offset++];
-				memcpy(&sa.angle, data + offset, sizeof(double));
+				double angle;
+				storage->outputs[i * stride + j] = data[offset++];
+				memcpy(&angle, data + offset, sizeof(double));
+				storage->angles[i * stride + j] = angle * InternalMath::m_2_PI;
 				offset += sizeof(double);
 			}
 		}
+
+		if (!hasAscendingAngles(storage->angles.data(), blockCount, stride, switchCount)) {
+			qWarning() << "CustomPwmTable:" << QObject::tr("Switch angles are not in ascending order; table rejected.");
+			*this = CustomPwmTable();
+			return;
+		}
+
+		angles = storage->angles.data();
+		outputs = storage->outputs.data();
+		startLevels = storage->startLevels.data();
+		owner = std::move(storage);
+		mapped = false;
 	}
 
-	Outcome::QStringResult<CustomPwmTable> CustomPwmTable::loadFromBin(const QString& path)
+	Outcome::QStringResult<CustomPwmTable> CustomPwmTable::fromMapped(const uint8_t* data, size_t size, std::shared_ptr<const void> owner)
 	{
-		QFile file(path);
-		if (!file.open(QIODevice::ReadOnly))
+		static_assert(std::endian::native == std::endian::little, "The mapped table format is little-endian.");
+
+		if (!data || size < sizeof(MappedTableHeader) || !hasMappedMagic(data, size))
+			return QObject::tr("Not a mapped switch angle table");
+
+		MappedTableHeader header;
+		memcpy(&header, data, sizeof(header));
+		if (header.version != MappedTableHeader::CURRENT_VERSION || header.headerSize != sizeof(MappedTableHeader))
+			return QObject::tr("Unsupported switch angle table version: %1").arg(header.version);
+
+		const size_t cells = size_t(header.blockCount) * header.stride;
+		if (header.stride < header.switchCount || header.stride % STRIDE_ALIGNMENT != 0 ||
+			header.fileSize > size ||
+			header.anglesOffset + cells * sizeof(double) > header.fileSize ||
+			header.outputsOffset + cells > header.fileSize ||
+			header.startLevelsOffset + size_t(header.blockCount) > header.fileSize)
+			return QObject::tr("Corrupted switch angle table");
+
+		CustomPwmTable table;
+		table.switchCount = header.switchCount;
+		table.modulationIndexDivision = header.modulationIndexDivision;
+		table.minimumModulationIndex = header.minimumModulationIndex;
+		table.blockCount = header.blockCount;
+		table.stride = header.stride;
+
+		if (reinterpret_cast<uintptr_t>(data + header.anglesOffset) % alignof(double) != 0)
+		{
+			// Can only happen with memory we don't control the placement of
+			// (e.g. some resource layouts); fall back to one aligned copy.
+			auto storage = std::make_shared<OwnedArrays>();
+			storage->angles.resize(cells);
+			memcpy(storage->angles.data(), data + header.anglesOffset, cells * sizeof(double));
+			storage->outputs.assign(data + header.outputsOffset, data + header.outputsOffset + cells);
+			storage->startLevels.assign(data + header.startLevelsOffset, data + header.startLevelsOffset + header.blockCount);
+			table.angles = storage->angles.data();
+			table.outputs = storage->outputs.data();
+			table.startLevels = storage->startLevels.data();
+			table.owner = std::move(storage);
+		}
+		else
+		{
+			table.angles = reinterpret_cast<const double*>(data + header.anglesOffset);
+			table.outputs = data + header.outputsOffset;
+			table.startLevels = data + header.startLevelsOffset;
+			table.owner = std::move(owner);
+			table.mapped = true;
+		}
+
+		if (!hasAscendingAngles(table.angles, table.blockCount, table.stride, table.switchCount))
+			return QObject::tr("Unsorted switch angle table");
+		return table;
+	}
+
+	Outcome::QStringResult<bool> CustomPwmTable::saveMapped(const QString& path) const
+	{
+		if (!isValid())
+			return QObject::tr("Cannot save an empty switch angle table");
+
+		const size_t cells = size_t(blockCount) * stride;
+		MappedTableHeader header{};
+		memcpy(header.magic, MappedTableHeader::MAGIC, sizeof(header.magic));
+		header.version = MappedTableHeader::CURRENT_VERSION;
+		header.headerSize = sizeof(MappedTableHeader);
+		header.switchCount = switchCount;
+		header.blockCount = blockCount;
+		header.stride = static_cast<uint32_t>(stride);
+		header.modulationIndexDivision = modulationIndexDivision;
+		header.minimumModulationIndex = minimumModulationIndex;
+		header.anglesOffset = static_cast<uint32_t>(alignUp(sizeof(MappedTableHeader), MappedTableHeader::ALIGNMENT));
+		header.outputsOffset = static_cast<uint32_t>(alignUp(header.anglesOffset + cells * sizeof(double), MappedTableHeader::ALIGNMENT));
+		header.startLevelsOffset = static_cast<uint32_t>(alignUp(header.outputsOffset + cells, MappedTableHeader::ALIGNMENT));
+		header.fileSize = static_cast<uint32_t>(header.startLevelsOffset + blockCount);
+
+		QByteArray image(header.fileSize, '\0');
+		memcpy(image.data(), &header, sizeof(header));
+		memcpy(image.data() + header.anglesOffset, angles, cells * sizeof(double));
+		memcpy(image.data() + header.outputsOffset, outputs, cells);
+		memcpy(image.data() + header.startLevelsOffset, startLevels, blockCount);
+
+		QSaveFile file(path);
+		if (!file.open(QIODevice::WriteOnly))
 			return QObject::tr("Failed to open file: %1").arg(file.errorString());
+		if (file.write(image) != image.size() || !file.commit())
+			return QObject::tr("Failed to write file: %1").arg(file.errorString());
+		return true;
+	}
+
+	Outcome::QStringResult<CustomPwmTable> CustomPwmTable::loadFromBin(const QString& path)
+	{
+		// Uncompressed resources already live in memory for the whole run
+		if (path.startsWith(u':')) {
+			const QResource resource(path);
+			if (resource.isValid() && resource.compressionAlgorithm() == QResource::NoCompression &&
+				hasMappedMagic(resource.data(), size_t(resource.size())))
+				return fromMapped(resource.data(), size_t(resource.size()), nullptr);
+		}
+
+		auto file = std::make_shared<QFile>(path);
+		if (!file->open(QIODevice::ReadOnly))
+			return QObject::tr("Failed to open file: %1").arg(file->errorString());
+
+		const auto size = file->size();
 
-		auto size = file.size();
+		const QByteArray magic = file->peek(sizeof(MappedTableHeader::MAGIC));
+		if (hasMappedMagic(magic.constData(), size_t(magic.size()))) {
+			// The mapping lives until the QFile (shared with the table) is closed
+			if (const uchar* view = file->map(0, size))
+				return fromMapped(view, size_t(size), std::shared_ptr<const void>(file, view));
+		}
 
-		std::vector<uint8_t> buffer(size);
-		if (!file.read(reinterpret_cast<char*>(buffer.data()), size))
-			return QObject::tr("Failed to read file: %1").arg(file.errorString());
+		auto buffer = std::make_shared<QByteArray>(file->readAll());
+		if (buffer->size() != size)
+			return QObject::tr("Failed to read file: %1").arg(file->errorString());
 
-		return CustomPwmTable(buffer.data(), size);
+		const auto* data = reinterpret_cast<const uint8_t*>(buffer->constData());
+		if (hasMappedMagic(data, size_t(size)))
+			return fromMapped(data, size_t(size), std::shared_ptr<const void>(buffer, data));
+		return CustomPwmTable(data, size_t(size));
 	}
 
 	int CustomPwmTable::getPwm(double M, double X) const
@@ -100,27 +282,56 @@ namespace VvvfSimulator::Vvvf::CustomPwm
 		int index = static_cast<int>((M - minimumModulationIndex) / modulationIndexDivision);
 		index = std::clamp(index, 0, static_cast<int>(blockCount) - 1);
 
-		const ModulationBlock& block = blocks[index];
-		return getPwm(block.switchAngles, X, block.startLevel);
+		return lookup(static_cast<uint32_t>(index), X);
 	}
 
-	int CustomPwmTable::getPwm(const std::vector<SwitchAngle>& angles, double X, uint8_t startLevel)
+	int CustomPwmTable::lookup(uint32_t block, double X) const
 	{
-		using namespace InternalMath;
+		using Batch = xsimd::batch<double>;
+		static_assert(STRIDE_ALIGNMENT % Batch::size == 0, "The block stride must be a whole number of registers.");
 
-		// Normalize angle to [0, 2π)
-		X = std::fmod(X, m_2_PI);
-		if (X < 0) X += m_2_PI;
+		int orthant;
+		const double angle = normalizeQuarterWave(X, orthant);
 
-		// Determine orthant (quadrant in 90° sectors)
-		int orthant = static_cast<int>(X / m_PI_2);
-		double angle = std::fmod(X, m_PI_2);
+		// Angles are ascending, so the active switch is the last one at or
+		// before the angle: count them instead of scanning for the first miss.
+		const double* row = angles + size_t(block) * stride;
+		const Batch position(angle);
+		size_t count = 0;
+		for (size_t i = 0; i < stride; i += Batch::size)
+			count += std::popcount(static_cast<uint64_t>((Batch::load_unaligned(row + i) <= position).mask()));
 
-		// Mirror angle for odd orthants
-		if (orthant & 0x01) {
-			angle = m_PI_2 - angle;
+		int pwm = count ? outputs[size_t(block) * stride + count - 1] : startLevels[block];
+
+		// Invert for orthants 2 and 3
+		if (orthant > 1) {
+			pwm = MAX_PWM_LEVEL - pwm;
 		}
 
+		return pwm;
+	}
+
+	ModulationBlock CustomPwmTable::getBlock(uint32_t index) const
+	{
+		ModulationBlock block;
+		if (index >= blockCount) return block;
+
+		block.startLevel = startLevels[index];
+		block.switchAngles.resize(switchCount);
+		for (uint8_t j = 0; j < switchCount; ++j) {
+			block.switchAngles[j].angle = angles[size_t(index) * stride + j] * InternalMath::m_PI_2;
+			block.switchAngles[j].output = outputs[size_t(index) * stride + j];
+		}
+		return block;
+	}
+
+	int CustomPwmTable::getPwm(const std::vector<SwitchAngle>& angles, double X, uint8_t startLevel)
+	{
+		using namespace InternalMath;
+
+		int orthant;
+		const double angle = normalizeQuarterWave(X, orthant) * m_PI_2;
+
 		// Find PWM level by comparing with switch angles
 		int pwm = startLevel;
 		for (const auto& sa : angles) {
@@ -143,115 +354,150 @@ namespace VvvfSimulator::Vvvf::CustomPwm
 
 	namespace CustomPwmPresets {
 		namespace {
+			constexpr size_t PresetCount = static_cast<size_t>(PresetId::L2Chm15Alt12) + 1;
+
+			/// One cache entry per preset. The table is written once inside
+			/// call_once and immutable afterwards, so every later reader gets it
+			/// without taking a lock, and concurrent first requests for the same
+			/// preset wait on a single load instead of each loading it.
+			struct CacheSlot
+			{
+				std::once_flag once;
+				std::shared_ptr<const CustomPwmTable> table;
+			};
+
+			std::array<CacheSlot, PresetCount> cache;
 			std::atomic<bool> loaded = false;
 			std::atomic<bool> loading = false;
-			QHash<CustomPwmPresets::PresetId, std::shared_ptr<CustomPwmTable>> cache;
+			std::atomic<bool> stopping = false;
+			QFuture<void> preloadTask;
+
+			QStringView getResourcePath(PresetId id)
+			{
+				// Map preset IDs to resource paths
+				// These will match the embedded Qt resources
+				static const QHash<PresetId, QStringView> pathMap = {
+					{PresetId::L2Chm3Default, u":/switchangle/L2Chm3Default.bin"},
+					{PresetId::L2Chm3Alt1, u":/switchangle/L2Chm3Alt1.bin"},
+					{PresetId::L2Chm3Alt2, u":/switchangle/L2Chm3Alt2.bin"},
+					{PresetId::L2Chm5Default, u":/switchangle/L2Chm5Default.bin"},
+					{PresetId::L2Chm5Alt1, u":/switchangle/L2Chm5Alt1.bin"},
+					{PresetId::L2Chm5Alt2, u":/switchangle/L2Chm5Alt2.bin"},
+					{PresetId::L2Chm5Alt3, u":/switchangle/L2Chm5Alt3.bin"},
+					{PresetId::L2Chm7Default, u":/switchangle/L2Chm7Default.bin"},
+					{PresetId::L2Chm7Alt1, u":/switchangle/L2Chm7Alt1.bin"},
+					{PresetId::L2Chm7Alt2, u":/switchangle/L2Chm7Alt2.bin"},
+					{PresetId::L2Chm7Alt3, u":/switchangle/L2Chm7Alt3.bin"},
+					{PresetId::L2Chm7Alt4, u":/switchangle/L2Chm7Alt4.bin"},
+					{PresetId::L2Chm7Alt5, u":/switchangle/L2Chm7Alt5.bin"},
+					{PresetId::L2Chm9Default, u":/switchangle/L2Chm9Default.bin"},
+					{PresetId::L2Chm9Alt1, u":/switchangle/L2Chm9Alt1.bin"},
+					{PresetId::L2Chm9Alt2, u":/switchangle/L2Chm9Alt2.bin"},
+					{PresetId::L2Chm9Alt3, u":/switchangle/L2Chm9Alt3.bin"},
+					{PresetId::L2Chm9Alt4, u":/switchangle/L2Chm9Alt4.bin"},
+					{PresetId::L2Chm9Alt5, u":/switchangle/L2Chm9Alt5.bin"},
+					{PresetId::L2Chm9Alt6, u":/switchangle/L2Chm9Alt6.bin"},
+					{PresetId::L2Chm9Alt7, u":/switchangle/L2Chm9Alt7.bin"},
+					{PresetId::L2Chm9Alt8, u":/switchangle/L2Chm9Alt8.bin"},
+					{PresetId::L2Chm11Default, u":/switchangle/L2Chm11Default.bin"},
+					{PresetId::L2Chm11Alt1, u":/switchangle/L2Chm11Alt1.bin"},
+					{PresetId::L2Chm11Alt2, u":/switchangle/L2Chm11Alt2.bin"},
+					{PresetId::L2Chm11Alt3, u":/switchangle/L2Chm11Alt3.bin"},
+					{PresetId::L2Chm11Alt4, u":/switchangle/L2Chm11Alt4.bin"},
+					{PresetId::L2Chm11Alt5, u":/switchangle/L2Chm11Alt5.bin"},
+					{PresetId::L2Chm11Alt6, u":/switchangle/L2Chm11Alt6.bin"},
+					{PresetId::L2Chm11Alt7, u":/switchangle/L2Chm11Alt7.bin"},
+					{PresetId::L2Chm11Alt8, u":/switchangle/L2Chm11Alt8.bin"},
+					{PresetId::L2Chm11Alt9, u":/switchangle/L2Chm11Alt9.bin"},
+					{PresetId::L2Chm11Alt10, u":/switchangle/L2Chm11Alt10.bin"},
+					{PresetId::L2Chm13Default, u":/switchangle/L2Chm13Default.bin"},
+					{PresetId::L2Chm13Alt1, u":/switchangle/L2Chm13Alt1.bin"},
+					{PresetId::L2Chm13Alt2, u":/switchangle/L2Chm13Alt2.bin"},
+					{PresetId::L2Chm13Alt3, u":/switchangle/L2Chm13Alt3.bin"},
+					{PresetId::L2Chm13Alt4, u":/switchangle/L2Chm13Alt4.bin"},
+					{PresetId::L2Chm13Alt5, u":/switchangle/L2Chm13Alt5.bin"},
+					{PresetId::L2Chm13Alt6, u":/switchangle/L2Chm13Alt6.bin"},
+					{PresetId::L2Chm13Alt7, u":/switchangle/L2Chm13Alt7.bin"},
+					{PresetId::L2Chm13Alt8, u":/switchangle/L2Chm13Alt8.bin"},
+					{PresetId::L2Chm15Default, u":/switchangle/L2Chm15Default.bin"},
+					{PresetId::L2Chm15Alt1, u":/switchangle/L2Chm15Alt1.bin"},
+					{PresetId::L2Chm15Alt2, u":/switchangle/L2Chm15Alt2.bin"},
+					{PresetId::L2Chm15Alt3, u":/switchangle/L2Chm15Alt3.bin"},
+					{PresetId::L2Chm15Alt4, u":/switchangle/L2Chm15Alt4.bin"},
+					{PresetId::L2Chm15Alt5, u":/switchangle/L2Chm15Alt5.bin"},
+					{PresetId::L2Chm15Alt6, u":/switchangle/L2Chm15Alt6.bin"},
+					{PresetId::L2Chm15Alt7, u":/switchangle/L2Chm15Alt7.bin"},
+					{PresetId::L2Chm15Alt8, u":/switchangle/L2Chm15Alt8.bin"},
+					{PresetId::L2Chm15Alt9, u":/switchangle/L2Chm15Alt9.bin"},
+					{PresetId::L2Chm15Alt10, u":/switchangle/L2Chm15Alt10.bin"},
+					{PresetId::L2Chm15Alt11, u":/switchangle/L2Chm15Alt11.bin"},
+					{PresetId::L2Chm15Alt12, u":/switchangle/L2Chm15Alt12.bin"},
+				};
+
+				auto it = pathMap.find(id);
+				return (it != pathMap.end()) ? it.value() : QStringView{u""};
+			}
+
+			std::shared_ptr<const CustomPwmTable> loadPreset(PresetId id)
+			{
+				QStringView path = getResourcePath(id);
+				if (path.empty()) return nullptr;
+
+				// Prefer a version 2 (mappable) table shipped next to the .bin one
+				QString compiledPath = path.toString();
+				compiledPath.replace(compiledPath.size() - 4, 4, u".cpwm");
+				auto table = CustomPwmTable::loadFromBin(QFile::exists(compiledPath) ? compiledPath : path.toString());
+				if (!table) return nullptr;
+
+				return std::make_shared<const CustomPwmTable>(std::move(table).value());
+			}
 		} // namespace
 
-		QStringView CustomPwmPresets::getResourcePath(PresetId id)
+		std::shared_ptr<const CustomPwmTable> getPreset(PresetId id)
 		{
-			// Map preset IDs to resource paths
-			// These will match the embedded Qt resources
-			static const QHash<PresetId, QStringView> pathMap = {
-				{PresetId::L2Chm3Default, u":/switchangle/L2Chm3Default.bin"},
-				{PresetId::L2Chm3Alt1, u":/switchangle/L2Chm3Alt1.bin"},
-				{PresetId::L2Chm3Alt2, u":/switchangle/L2Chm3Alt2.bin"},
-				{PresetId::L2Chm5Default, u":/switchangle/L2Chm5Default.bin"},
-				{PresetId::L2Chm5Alt1, u":/switchangle/L2Chm5Alt1.bin"},
-				{PresetId::L2Chm5Alt2, u":/switchangle/L2Chm5Alt2.bin"},
-				{PresetId::L2Chm5Alt3, u":/switchangle/L2Chm5Alt3.bin"},
-				{PresetId::L2Chm7Default, u":/switchangle/L2Chm7Default.bin"},
-				{PresetId::L2Chm7Alt1, u":/switchangle/L2Chm7Alt1.bin"},
-				{PresetId::L2Chm7Alt2, u":/switchangle/L2Chm7Alt2.bin"},
-				{PresetId::L2Chm7Alt3, u":/switchangle/L2Chm7Alt3.bin"},
-				{PresetId::L2Chm7Alt4, u":/switchangle/L2Chm7Alt4.bin"},
-				{PresetId::L2Chm7Alt5, u":/switchangle/L2Chm7Alt5.bin"},
-				{PresetId::L2Chm9Default, u":/switchangle/L2Chm9Default.bin"},
-				{PresetId::L2Chm9Alt1, u":/switchangle/L2Chm9Alt1.bin"},
-				{PresetId::L2Chm9Alt2, u":/switchangle/L2Chm9Alt2.bin"},
-				{PresetId::L2Chm9Alt3, u":/switchangle/L2Chm9Alt3.bin"},
-				{PresetId::L2Chm9Alt4, u":/switchangle/L2Chm9Alt4.bin"},
-				{PresetId::L2Chm9Alt5, u":/switchangle/L2Chm9Alt5.bin"},
-				{PresetId::L2Chm9Alt6, u":/switchangle/L2Chm9Alt6.bin"},
-				{PresetId::L2Chm9Alt7, u":/switchangle/L2Chm9Alt7.bin"},
-				{PresetId::L2Chm9Alt8, u":/switchangle/L2Chm9Alt8.bin"},
-				{PresetId::L2Chm11Default, u":/switchangle/L2Chm11Default.bin"},
-				{PresetId::L2Chm11Alt1, u":/switchangle/L2Chm11Alt1.bin"},
-				{PresetId::L2Chm11Alt2, u":/switchangle/L2Chm11Alt2.bin"},
-				{PresetId::L2Chm11Alt3, u":/switchangle/L2Chm11Alt3.bin"},
-				{PresetId::L2Chm11Alt4, u":/switchangle/L2Chm11Alt4.bin"},
-				{PresetId::L2Chm11Alt5, u":/switchangle/L2Chm11Alt5.bin"},
-				{PresetId::L2Chm11Alt6, u":/switchangle/L2Chm11Alt6.bin"},
-				{PresetId::L2Chm11Alt7, u":/switchangle/L2Chm11Alt7.bin"},
-				{PresetId::L2Chm11Alt8, u":/switchangle/L2Chm11Alt8.bin"},
-				{PresetId::L2Chm11Alt9, u":/switchangle/L2Chm11Alt9.bin"},
-				{PresetId::L2Chm11Alt10, u":/switchangle/L2Chm11Alt10.bin"},
-				{PresetId::L2Chm13Default, u":/switchangle/L2Chm13Default.bin"},
-				{PresetId::L2Chm13Alt1, u":/switchangle/L2Chm13Alt1.bin"},
-				{PresetId::L2Chm13Alt2, u":/switchangle/L2Chm13Alt2.bin"},
-				{PresetId::L2Chm13Alt3, u":/switchangle/L2Chm13Alt3.bin"},
-				{PresetId::L2Chm13Alt4, u":/switchangle/L2Chm13Alt4.bin"},
-				{PresetId::L2Chm13Alt5, u":/switchangle/L2Chm13Alt5.bin"},
-				{PresetId::L2Chm13Alt6, u":/switchangle/L2Chm13Alt6.bin"},
-				{PresetId::L2Chm13Alt7, u":/switchangle/L2Chm13Alt7.bin"},
-				{PresetId::L2Chm13Alt8, u":/switchangle/L2Chm13Alt8.bin"},
-				{PresetId::L2Chm15Default, u":/switchangle/L2Chm15Default.bin"},
-				{PresetId::L2Chm15Alt1, u":/switchangle/L2Chm15Alt1.bin"},
-				{PresetId::L2Chm15Alt2, u":/switchangle/L2Chm15Alt2.bin"},
-				{PresetId::L2Chm15Alt3, u":/switchangle/L2Chm15Alt3.bin"},
-				{PresetId::L2Chm15Alt4, u":/switchangle/L2Chm15Alt4.bin"},
-				{PresetId::L2Chm15Alt5, u":/switchangle/L2Chm15Alt5.bin"},
-				{PresetId::L2Chm15Alt6, u":/switchangle/L2Chm15Alt6.bin"},
-				{PresetId::L2Chm15Alt7, u":/switchangle/L2Chm15Alt7.bin"},
-				{PresetId::L2Chm15Alt8, u":/switchangle/L2Chm15Alt8.bin"},
-				{PresetId::L2Chm15Alt9, u":/switchangle/L2Chm15Alt9.bin"},
-				{PresetId::L2Chm15Alt10, u":/switchangle/L2Chm15Alt10.bin"},
-				{PresetId::L2Chm15Alt11, u":/switchangle/L2Chm15Alt11.bin"},
-				{PresetId::L2Chm15Alt12, u":/switchangle/L2Chm15Alt12.bin"},
-			};
-
-			auto it = pathMap.find(id);
-			return (it != pathMap.end()) ? it.value() : QStringView{u""};
+			const auto index = static_cast<size_t>(id);
+			if (index >= PresetCount) return nullptr;
+
+			// Load on demand; a failed load is cached as nullptr, as embedded
+			// resources don't appear later
+			CacheSlot& slot = cache[index];
+			std::call_once(slot.once, [&slot, id]() { slot.table = loadPreset(id); });
+			return slot.table;
 		}
 
-		void CustomPwmPresets::loadPreset(PresetId id)
+		void preloadAll()
 		{
-			QStringView path = getResourcePath(id);
-			if (path.empty()) return;
-
-			auto table = CustomPwmTable::loadFromBin(path.toString());
-			if (table) {
-				cache[id] = std::make_shared<CustomPwmTable>(table.value());
-			}
+			bool expected = false;
+			if (loaded || stopping || !loading.compare_exchange_strong(expected, true)) return;
+
+			// The task reads the cache and the resources, so it must be done
+			// before the application (and then the statics) go away
+			static std::once_flag registered;
+			std::call_once(registered, []() { qAddPostRoutine(stopPreload); });
+
+			preloadTask = QtConcurrent::run([]() {
+				QList<PresetId> ids;
+				for (int i = static_cast<int>(PresetId::L2Chm3Default);
+					i <= static_cast<int>(PresetId::L2Chm15Alt12); ++i) {
+					ids.append(static_cast<PresetId>(i));
+				}
+				// One task per preset on the global pool
+				QtConcurrent::blockingMap(ids, [](PresetId id) { if (!stopping) getPreset(id); });
+
+				loaded = !stopping;
+				loading = false;
+			});
 		}
 
-		std::shared_ptr<CustomPwmTable> CustomPwmPresets::getPreset(PresetId id)
+		void stopPreload()
 		{
-			// Check cache first
-			auto it = cache.find(id);
-			if (it != cache.end()) {
-				return it.value();
-			}
-
-			// Load on demand
-			loadPreset(id);
-			return cache[id]; // May be nullptr if load failed
+			stopping = true;
+			preloadTask.waitForFinished();
 		}
 
-		void CustomPwmPresets::preloadAll()
+		bool isLoaded()
 		{
-			if (loaded || loading) return;
-			loading = true;
-
-			// Load all presets
-			// TODO: In production, this would be done asynchronously
-			for (int i = static_cast<int>(PresetId::L2Chm3Default); 
-				i <= static_cast<int>(PresetId::L2Chm15Alt12); ++i) {
-				loadPreset(static_cast<PresetId>(i));
-			}
-
-			loaded = true;
-			loading = false;
+			return loaded;
 		}
 	}
 
@@ -51,7 +51,45 @@ namespace VvvfSimulator::Vvvf::CustomPwm
 		std::vector<SwitchAngle> switchAngles;
 	};
 
+	/// On-disk header of the mappable switch angle table format (version 2)
+	///
+	/// The header is followed by the three arrays exactly as CustomPwmTable keeps
+	/// them in memory, each starting on an ALIGNMENT byte boundary, so a table
+	/// can be queried straight from a memory mapped file or an uncompressed Qt
+	/// resource without parsing. All values are little-endian.
+	struct MappedTableHeader
+	{
+		static constexpr char MAGIC[8] = {'V', 'V', 'V', 'F', 'C', 'P', 'W', 'M'};
+		static constexpr uint16_t CURRENT_VERSION = 2;
+		static constexpr size_t ALIGNMENT = 64;
+
+		char magic[8];
+		uint16_t version;
+		uint16_t headerSize;
+		uint8_t switchCount;
+		uint8_t reserved0[3];
+		uint32_t blockCount;
+		uint32_t stride;                   // Angles per block, padding included
+		double modulationIndexDivision;
+		double minimumModulationIndex;
+		uint32_t anglesOffset;             // blockCount * stride doubles, quarter-wave units
+		uint32_t outputsOffset;            // blockCount * stride uint8
+		uint32_t startLevelsOffset;        // blockCount uint8
+		uint32_t fileSize;
+		uint8_t reserved1[8];
+	};
+	static_assert(sizeof(MappedTableHeader) == MappedTableHeader::ALIGNMENT);
+
 	/// Complete custom PWM lookup table
+	///
+	/// Stored as a structure of arrays: one contiguous angle array and one output
+	/// array, each block occupying a fixed stride (the switch count rounded up to
+	/// a whole SIMD register, padded with +inf angles). Angles are kept in
+	/// quarter-wave units (radians * 2/pi, so 0 - 1) to make the per-sample
+	/// normalization a single floor.
+	///
+	/// The arrays are either owned (legacy .bin files) or borrowed from a mapped
+	/// version 2 file or resource; copies share them and are cheap.
 	class CustomPwmTable
 	{
 	public:
@@ -60,8 +98,15 @@ namespace VvvfSimulator::Vvvf::CustomPwm
 		/// Load from binary stream (original .bin format)
 		explicit CustomPwmTable(const uint8_t* data, size_t size);
 
-		/// Load from file path
+		/// Load from file path or Qt resource path
+		/// Version 2 tables are mapped (or used in place for uncompressed
+		/// resources) and queried without copying; original .bin tables are parsed.
 		static Outcome::QStringResult<CustomPwmTable> loadFromBin(const QString& path);
+		/// Use a version 2 table in place. owner keeps the memory alive, and may
+		/// be null for memory that lives as long as the program (e.g. resources).
+		static Outcome::QStringResult<CustomPwmTable> fromMapped(const uint8_t* data, size_t size, std::shared_ptr<const void> owner);
+		/// Write this table in the version 2 (mappable) format
+		Outcome::QStringResult<bool> saveMapped(const QString& path) const;
 		static Outcome::QStringResult<CustomPwmTable> loadFromRfl(const QString& path);
 		explicit CustomPwmTable(const QString& path, bool fromBin);
 
@@ -74,6 +119,9 @@ namespace VvvfSimulator::Vvvf::CustomPwm
 		/// Static variant taking switch angle array directly
 		static int getPwm(const std::vector<SwitchAngle>& angles, double X, uint8_t startLevel);
 
+		/// Rebuild a block in the original array-of-structures form
+		ModulationBlock getBlock(uint32_t index) const;
+
 		// Getters
 		uint8_t getSwitchCount() const { return switchCount; }
 		double getModulationIndexDivision() const { return modulationIndexDivision; }
@@ -81,16 +129,34 @@ namespace VvvfSimulator::Vvvf::CustomPwm
 		uint32_t getBlockCount() const { return blockCount; }
 		bool isValid() const { return blockCount > 0 && switchCount > 0; }
 
+		/// Angles per block in the flat arrays, including padding
+		size_t getStride() const { return stride; }
+		/// Whether the arrays are borrowed from a version 2 file/resource
+		bool isMapped() const { return mapped; }
+
 	private:
 		static constexpr int MAX_PWM_LEVEL = 2;
+		/// Block stride granularity, in angles; one AVX-512 register of doubles
+		static constexpr size_t STRIDE_ALIGNMENT = 8;
 
 		uint8_t switchCount = 0;
 		double modulationIndexDivision = 0.0;
 		double minimumModulationIndex = 0.0;
 		uint32_t blockCount = 0;
-		std::vector<ModulationBlock> blocks;
+		size_t stride = 0;
+		bool mapped = false;
+
+		/// Keeps the memory behind the arrays alive
+		std::shared_ptr<const void> owner;
+		/// blockCount * stride quarter-wave angles, ascending per block
+		const double* angles = nullptr;
+		/// blockCount * stride output levels
+		const uint8_t* outputs = nullptr;
+		/// blockCount start levels
+		const uint8_t* startLevels = nullptr;
 
 		void parseBinaryData(const uint8_t* data, size_t size);
+		int lookup(uint32_t block, double X) const;
 	};
 
 	/// Preset manager for embedded switch angle tables
@@ -157,12 +223,18 @@ namespace VvvfSimulator::Vvvf::CustomPwm
 			// SHE presets would go here
 		};
 
-		/// Get preset table by ID (lazy loading)
-		std::shared_ptr<CustomPwmTable> getPreset(PresetId id);
+		/// Get preset table by ID (lazy loading). Safe to call from any thread;
+		/// once loaded, lookups don't lock.
+		std::shared_ptr<const CustomPwmTable> getPreset(PresetId id);
 
-		/// Preload all presets asynchronously
+		/// Preload all presets asynchronously, in parallel on the global thread pool
 		void preloadAll();
 
+		/// Skip the presets preloadAll() has not started yet and wait for the
+		/// rest; later preloadAll() calls do nothing. Runs automatically when
+		/// the QCoreApplication is destroyed.
+		void stopPreload();
+
 		/// Check if presets are loaded
 		bool isLoaded();
 	};
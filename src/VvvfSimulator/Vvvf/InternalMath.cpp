@@ -8,6 +8,7 @@
 #include <QtMinMax>
 
 namespace VvvfSimulator::Vvvf::InternalMath {
+namespace Functions {
 double triangle(double x) noexcept {
   double phase = m_2_PI * x - 4.0 * std::floor(x * m_1_2PI);
   if (1.0 <= phase && phase < 3)
@@ -27,17 +28,19 @@ double square(double x) noexcept {
   double fixed_x = x - std::floor(x * m_1_2PI) * m_2PI;
   return fixed_x * m_1_PI > 1.0 ? -1.0 : 1.0;
 }
+} // namespace Functions
 
 namespace EquationSolver {
 double NewtonMethod::operator()(double begin, double tolerance,
                                 unsigned int n) {
-  static const auto getDerivative = [this](double x) {
+  // Not static: they capture this solver's function
+  const auto getDerivative = [this](double x) {
     double Fxdx = function(x + dx);
     double Fx = function(x);
     double Dy = Fxdx - Fx;
     return Dy / dx;
   };
-  static const auto getZeroIntersect = [this](double x) {
+  const auto getZeroIntersect = [this, &getDerivative](double x) {
     return -function(x) / getDerivative(x) + x;
   };
 
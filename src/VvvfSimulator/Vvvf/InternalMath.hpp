@@ -47,6 +47,8 @@ double square(double x) noexcept;
 namespace EquationSolver {
 typedef std::function<double(double)> Function;
 
+enum class EquationSolverType { Newton, Bissection };
+
 struct NewtonMethod {
   Function function;
   double dx{};
@@ -0,0 +1,221 @@
+// Copyright © 2025 VvvfGeeks, VVVF Systems
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-or-later
+//
+// Vvvf/Model.cpp
+
+#include "Model.hpp"
+// Standard Library
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <variant>
+// Packages
+#include <QHash>
+// Internal
+#include "InternalMath.hpp"
+
+namespace VvvfSimulator::Vvvf {
+Model::ElectricalParameter::ElectricalParameter() = default;
+
+Model::ElectricalParameter::ElectricalParameter(
+    bool isNone, bool isZeroOutput, int pwmLevel,
+    const Data::Vvvf::PulseControl *pulsePattern,
+    const CarrierParameter *carrierFrequency, const PulseDataSet *pulseData,
+    double baseWaveFrequency, const double *baseWaveAmplitude)
+    : isNone(isNone), isZeroOutput(isZeroOutput), pwmLevel(pwmLevel),
+      pulsePattern(pulsePattern),
+      carrierFrequency(carrierFrequency ? std::optional(*carrierFrequency)
+                                        : std::nullopt),
+      pulseData(pulseData ? *pulseData : PulseDataSet{}),
+      baseWaveFrequency(baseWaveFrequency),
+      baseWaveAngleFrequency(baseWaveFrequency * InternalMath::m_2PI),
+      baseWaveAmplitude(baseWaveAmplitude ? std::optional(*baseWaveAmplitude)
+                                          : std::nullopt) {}
+
+Model::ElectricalParameter::ElectricalParameter(int pwmLevel,
+                                                double baseWaveFrequency)
+    : ElectricalParameter(true, true, pwmLevel, nullptr, nullptr, nullptr,
+                          baseWaveFrequency, nullptr) {}
+
+void Model::updateVideoSnapshot(double sineFrequency) noexcept {
+  if (!captureVideoSnapshot)
+    return;
+
+  videoSnapshot.isNone = electricalState.isNone;
+  videoSnapshot.sineFrequency = sineFrequency;
+  if (electricalState.isNone)
+    return;
+
+  videoSnapshot.pulsePattern = electricalState.pulsePattern;
+  if (electricalState.carrierFrequency)
+    videoSnapshot.carrierFrequency = *electricalState.carrierFrequency;
+  videoSnapshot.pulseData = electricalState.pulseData;
+  videoSnapshot.sineAmplitude = electricalState.baseWaveAmplitude.value_or(0.0);
+  videoSnapshot.carrierFrequencyValue = carrierInstance.frequency();
+}
+
+void Model::resolveElectricalState(Data::Vvvf::Compiled::Resolver &resolver,
+                                   int pwmLevel) {
+  using PulseDataValue = Data::Vvvf::PulseControl::Pulse::PulseDataValue;
+  using RandomValue =
+      Data::Vvvf::PulseControl::AsyncControl::RandomModulation::RandomValue;
+  using CarrierMode = Data::Vvvf::PulseControl::AsyncControl::
+      CarrierFrequency::CarrierFrequencyMode;
+
+  const double sineFrequency = baseWaveAngleFreq * InternalMath::m_1_2PI;
+  Data::Vvvf::Compiled::State state;
+  state.controlFrequency = controlFrequency;
+  state.sineFrequency = sineFrequency;
+  state.brake = brake;
+  state.masconOff = powerOff;
+  state.freeRun = freeRun;
+  const Data::Vvvf::Compiled::Resolved &resolved = resolver.resolve(state);
+
+  if (!resolved.region) {
+    electricalState = ElectricalParameter(pwmLevel, sineFrequency);
+  } else {
+    const Data::Vvvf::PulseControl &pattern = resolved.region->pattern;
+    const auto valueOf = [this](const auto &value, auto movingMode) {
+      return value.mode == movingMode
+                 ? Data::Vvvf::Compiled::Function(value.movingValue)(
+                       controlFrequency)
+                 : value.constant;
+    };
+
+    ElectricalParameter &e = electricalState;
+    e.isNone = false;
+    e.isZeroOutput = resolved.amplitude == 0.0;
+    e.pwmLevel = pwmLevel;
+    e.pulsePattern = &pattern;
+    e.pulseData.clear();
+    for (const auto &[key, value] : pattern.pulseMode.pulseData)
+      e.pulseData.set(key,
+                      valueOf(value, PulseDataValue::PulseDataValueMode::Moving));
+
+    ElectricalParameter::CarrierParameter carrier;
+    const auto &random = pattern.asyncModulationData.random;
+    const double range =
+        valueOf(random.range, RandomValue::RandomValueMode::Moving);
+    if (range != 0.0)
+      carrier.randomRange.emplace(
+          range, valueOf(random.interval, RandomValue::RandomValueMode::Moving),
+          randomSeed);
+    const auto &carrierWave = pattern.asyncModulationData.carrierWaveData;
+    if (carrierWave.mode == CarrierMode::Periodic)
+      carrier.baseFrequency = ElectricalParameter::CarrierParameter::
+          PeriodicFrequency(carrierWave.vibrato.highest,
+                            carrierWave.vibrato.lowest,
+                            carrierWave.vibrato.interval);
+    else
+      carrier.baseFrequency = resolved.carrierFrequency;
+    e.carrierFrequency = carrier;
+
+    e.baseWaveFrequency = sineFrequency;
+    e.baseWaveAngleFrequency = baseWaveAngleFreq;
+    e.baseWaveAmplitude = resolved.amplitude;
+  }
+
+  updateVideoSnapshot(sineFrequency);
+}
+
+namespace Benchmark {
+Util::Benchmark::Throughput
+measureElectricalState(const Data::Vvvf &soundData, qsizetype samples) {
+  using CarrierParameter = Model::ElectricalParameter::CarrierParameter;
+  using PulseDataKey = Data::Vvvf::PulseControl::Pulse::PulseDataKey;
+  using PulseDataValue = Data::Vvvf::PulseControl::Pulse::PulseDataValue;
+  using RandomValue =
+      Data::Vvvf::PulseControl::AsyncControl::RandomModulation::RandomValue;
+  using CarrierMode = Data::Vvvf::PulseControl::AsyncControl::
+      CarrierFrequency::CarrierFrequencyMode;
+
+  // What every sample used to hold: the former ElectricalParameter members
+  struct DeepCopy {
+    std::optional<Data::Vvvf::PulseControl> pulsePattern;
+    std::optional<QHash<PulseDataKey, double>> pulseData;
+    std::shared_ptr<CarrierParameter::RandomFrequency> randomRange;
+    std::variant<std::shared_ptr<CarrierParameter::ConstantFrequency>,
+                 std::shared_ptr<CarrierParameter::PeriodicFrequency>>
+        baseFrequency;
+    std::optional<double> baseWaveAmplitude;
+  };
+
+  const Data::Vvvf::Compiled compiled = soundData.getCompiled();
+  const double maxFrequency = std::max(soundData.getMaximumFrequency(), 1.0);
+  Util::Benchmark::Throughput result;
+  volatile double sink = 0.0; // Keeps the results observable
+
+  // Before: same region lookup, filled into the deep-copying layout
+  const auto deepCopySweep = [&]() -> qsizetype {
+    Data::Vvvf::Compiled::Resolver resolver(compiled);
+    resolver.setCrossCheck(false);
+    DeepCopy state;
+    for (qsizetype i = 0; i < samples; ++i) {
+      Data::Vvvf::Compiled::State input;
+      input.controlFrequency = maxFrequency * double(i) / double(samples);
+      input.sineFrequency = input.controlFrequency;
+      const Data::Vvvf::Compiled::Resolved &resolved = resolver.resolve(input);
+      state = DeepCopy{};
+      if (resolved.region) {
+        const Data::Vvvf::PulseControl &pattern = resolved.region->pattern;
+        const auto valueOf = [&](const auto &value, auto movingMode) {
+          return value.mode == movingMode
+                     ? Data::Vvvf::Compiled::Function(value.movingValue)(
+                           input.controlFrequency)
+                     : value.constant;
+        };
+        state.pulsePattern = pattern;
+        QHash<PulseDataKey, double> pulseData;
+        for (const auto &[key, value] : pattern.pulseMode.pulseData)
+          pulseData.insert(
+              key, valueOf(value, PulseDataValue::PulseDataValueMode::Moving));
+        state.pulseData = std::move(pulseData);
+        const auto &random = pattern.asyncModulationData.random;
+        const double range =
+            valueOf(random.range, RandomValue::RandomValueMode::Moving);
+        if (range != 0.0)
+          state.randomRange = std::make_shared<CarrierParameter::RandomFrequency>(
+              range,
+              valueOf(random.interval, RandomValue::RandomValueMode::Moving),
+              int64_t(0));
+        const auto &carrierWave = pattern.asyncModulationData.carrierWaveData;
+        if (carrierWave.mode == CarrierMode::Periodic)
+          state.baseFrequency =
+              std::make_shared<CarrierParameter::PeriodicFrequency>(
+                  carrierWave.vibrato.highest, carrierWave.vibrato.lowest,
+                  carrierWave.vibrato.interval);
+        else
+          state.baseFrequency =
+              std::make_shared<CarrierParameter::ConstantFrequency>(
+                  resolved.carrierFrequency);
+        state.baseWaveAmplitude = resolved.amplitude;
+      }
+      sink = sink + state.baseWaveAmplitude.value_or(0.0);
+    }
+    return samples;
+  };
+
+  // After: the allocation-free state, with the video snapshot captured
+  const auto modelSweep = [&]() -> qsizetype {
+    Model model;
+    Data::Vvvf::Compiled::Resolver resolver(compiled);
+    resolver.setCrossCheck(false);
+    for (qsizetype i = 0; i < samples; ++i) {
+      model.controlFrequency = maxFrequency * double(i) / double(samples);
+      model.baseWaveAngleFreq =
+          model.controlFrequency * InternalMath::m_2PI;
+      model.resolveElectricalState(resolver, compiled.level);
+      sink = sink + model.electricalState.baseWaveAmplitude.value_or(0.0);
+    }
+    return samples;
+  };
+
+  result.beforeRate = Util::Benchmark::measureRate(deepCopySweep, &result.items);
+  result.afterRate = Util::Benchmark::measureRate(modelSweep);
+
+  Util::Benchmark::report("Electrical state resolution", result,
+                          "deep copy", "allocation-free");
+  return result;
+}
+} // namespace Benchmark
+} // namespace VvvfSimulator::Vvvf
@@ -8,7 +8,9 @@
 // Standard Library
 #include <array>
 #include <memory>
+#include <cstdint>
 #include <optional>
+#include <type_traits>
 #include <variant>
 // Packages
 #include <QHash>
@@ -17,6 +19,7 @@
 #include "Modulation.hpp"
 #include "../Data/VehicleAudio.hpp"
 #include "../Data/Vvvf.hpp"
+#include "../Util/Benchmark.hpp"
 
 namespace VvvfSimulator::Vvvf {
   // TODO: Replace by actual DeltaSigma header include
@@ -112,7 +115,7 @@ struct Model {
         int64_t seed;
 
         constexpr RandomFrequency() = default;
-        constexpr RanfomFrequency(double range, double interval, int64_t seed)
+        constexpr RandomFrequency(double range, double interval, int64_t seed)
             : range(range), interval(interval), seed(seed) {}
       };
       typedef double ConstantFrequency;
@@ -124,25 +127,63 @@ struct Model {
             : highest(hi), lowest(lo), interval(in) {}
       };
 
-      std::shared_ptr<RandomFrequency> randomRange;
-      std::variant<std::shared_ptr<ConstantFrequency>,
-        std::shared_ptr<PeriodicFrequency>> baseFrequency;
+      // Held by value: these are recomputed for every sample, so they must
+      // not cost an allocation (or an atomic reference count) each time.
+      std::optional<RandomFrequency> randomRange;
+      std::variant<ConstantFrequency, PeriodicFrequency> baseFrequency;
 
       constexpr CarrierParameter() = default;
       constexpr CarrierParameter(const CarrierParameter &other) = default;
+      constexpr CarrierParameter &operator=(const CarrierParameter &other) = default;
 
       constexpr auto sizeOf() const noexcept { return sizeof(*this); }
     };
 
+    using PulseDataKey = Data::Vvvf::PulseControl::Pulse::PulseDataKey;
+
+    // Pulse data values indexed by key, with a bit per key telling which are
+    // set. Replaces a per-sample QHash/QMap copy.
+    struct PulseDataSet {
+      static constexpr size_t keyCount =
+          static_cast<size_t>(PulseDataKey::UpdateFrequency) + 1;
+
+      std::array<double, keyCount> values{};
+      uint8_t presentMask = 0;
+
+      constexpr bool contains(PulseDataKey key) const noexcept {
+        return presentMask & bit(key);
+      }
+      constexpr bool empty() const noexcept { return presentMask == 0; }
+      // Returns defaultValue if the key is not set
+      constexpr double value(PulseDataKey key,
+                             double defaultValue = 0.0) const noexcept {
+        return contains(key) ? values[static_cast<size_t>(key)] : defaultValue;
+      }
+      constexpr void set(PulseDataKey key, double value) noexcept {
+        values[static_cast<size_t>(key)] = value;
+        presentMask |= bit(key);
+      }
+      constexpr void remove(PulseDataKey key) noexcept {
+        presentMask &= ~bit(key);
+      }
+      constexpr void clear() noexcept { presentMask = 0; }
+
+    private:
+      static constexpr uint8_t bit(PulseDataKey key) noexcept {
+        return uint8_t(1u << static_cast<unsigned>(key));
+      }
+    };
+    static_assert(PulseDataSet::keyCount <= 8,
+                  "PulseDataSet::presentMask has a bit per key.");
+
     bool isNone = true;
     bool isZeroOutput = true;
     int pwmLevel;
-    // TODO: Determine if/whether it would be better to leave these as shared
-    // pointers or as optionals
-    std::optional<Data::Vvvf::PulseControl> pulsePattern;
+    // Handle into the (immutable) sound data the state was resolved from; the
+    // data must outlive the state.
+    const Data::Vvvf::PulseControl *pulsePattern = nullptr;
     std::optional<CarrierParameter> carrierFrequency;
-    std::optional<QHash<Data::Vvvf::PulseControl::Pulse::PulseDataKey, double>>
-        pulseData;
+    PulseDataSet pulseData;
     double baseWaveFrequency;
     double baseWaveAngleFrequency;
     std::optional<double> baseWaveAmplitude;
@@ -154,8 +195,7 @@ struct Model {
       int pwmLevel,
       const Data::Vvvf::PulseControl *pulsePattern,
       const CarrierParameter *carrierFrequency,
-      const QHash<Data::Vvvf::PulseControl::Pulse::PulseDataKey,
-        double> *pulseData,
+      const PulseDataSet *pulseData,
       double baseWaveFrequency,
       const double *baseWaveAmplitude
     );
@@ -164,8 +204,40 @@ struct Model {
     constexpr static auto dummy = sizeof(pulseData);
     constexpr auto sizeOf() const noexcept { return sizeof(*this); }
   };
+  static_assert(std::is_trivially_copyable_v<ElectricalParameter>);
 
   ElectricalParameter electricalState = ElectricalParameter(2, 0.0);
+
+  // What the video generators display for the current sample. Fixed size
+  // and trivially copyable, so capturing it every sample costs a memcpy.
+  struct VideoSnapshot {
+    const Data::Vvvf::PulseControl *pulsePattern = nullptr;
+    ElectricalParameter::CarrierParameter carrierFrequency;
+    ElectricalParameter::PulseDataSet pulseData;
+    double sineAmplitude = 0.0;
+    double sineFrequency = 0.0;
+    double carrierFrequencyValue = 0.0;
+    bool isNone = true;
+
+    constexpr auto sizeOf() const noexcept { return sizeof(*this); }
+  };
+  static_assert(std::is_trivially_copyable_v<VideoSnapshot>);
+
+  // Audio-only renders can turn this off; videoSnapshot then keeps whatever
+  // was captured last.
+  bool captureVideoSnapshot = true;
+  VideoSnapshot videoSnapshot;
+  // Copies the displayed values out of electricalState, if enabled
+  void updateVideoSnapshot(double sineFrequency) noexcept;
+
+  // Seed of the random carrier modulation
+  int64_t randomSeed = 0;
+  // Per-sample counterpart of YamlVvvfWave::calculateYaml(): resolves the
+  // active pattern for the current control state and fills electricalState
+  // from it, then captures the video snapshot (see captureVideoSnapshot).
+  // Allocation-free; electricalState points into the resolver's sound data.
+  void resolveElectricalState(Data::Vvvf::Compiled::Resolver &resolver,
+                              int pwmLevel);
 #pragma endregion
 
 #pragma region Modulation
@@ -176,4 +248,13 @@ struct Model {
 
   constexpr auto sizeOf() const noexcept { return sizeof(*this); }
 };
+
+namespace Benchmark {
+// Measures the per-sample electrical state over a control frequency sweep
+// of the given sound: the former deep copy of the pattern, pulse data and
+// carrier parameters (before) against Model::resolveElectricalState() with
+// the video snapshot captured (after). Both use the same region lookup.
+Util::Benchmark::Throughput
+measureElectricalState(const Data::Vvvf &soundData, qsizetype samples);
+} // namespace Benchmark
 } // namespace VvvfSimulator::Vvvf
\ No newline at end of file
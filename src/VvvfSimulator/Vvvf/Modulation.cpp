@@ -2,7 +2,6 @@
 // Standard Library
 #include <cmath>
 #include <exception>
-#include <random>
 #include <string>
 // Internal
 #include "InternalMath.hpp"
@@ -39,7 +38,7 @@ namespace VvvfSimulator::Vvvf::Modulation {
     }
 
     RandomFrequency::RandomFrequency(int64_t seed)
-        : randomInstance(seed)
+        : randomStream(static_cast<uint64_t>(seed))
     {}
 
     using ParameterT = Model::ElectricalParameter::CarrierParameter::RandomFrequency;
@@ -48,8 +47,8 @@ namespace VvvfSimulator::Vvvf::Modulation {
 
     RandomFrequency::RandomFrequency(const decltype(parameter) &param, double baseFrequency)
         : parameter(param)
-        , randomInstance(parameter ? parameter->seed : 0)
         , baseFrequency(baseFrequency)
+        , randomStream(parameter ? static_cast<uint64_t>(parameter->seed) : 0)
     {}
 
     void RandomFrequency::setState(bool simple, double time)
@@ -60,8 +59,24 @@ namespace VvvfSimulator::Vvvf::Modulation {
 
     void RandomFrequency::setCustomParameter(const decltype(parameter) &param, double baseFrequency)
     {
-        this->parameter = parameter;
+        this->parameter = param;
         this->baseFrequency = baseFrequency;
+        if (param) randomStream = Random::CounterStream(static_cast<uint64_t>(param->seed));
+    }
+
+    uint64_t RandomFrequency::updateIndex() const noexcept
+    {
+        // Interval k starts with the first sample past epoch + k * interval,
+        // the same strict comparison the sequential draw used
+        if (!parameter || !(parameter->interval > 0.0) || time <= epoch) return 0;
+        return static_cast<uint64_t>(std::ceil((time - epoch) / parameter->interval)) - 1;
+    }
+
+    double RandomFrequency::offsetAt(const Random::CounterStream &stream, uint64_t index) noexcept
+    {
+        // No offset until the first update
+        if (index == 0) return 0.0;
+        return stream.unitAt(index) - 0.5;
     }
 
     double RandomFrequency::calculate()
@@ -69,18 +84,13 @@ namespace VvvfSimulator::Vvvf::Modulation {
         if (!parameter) return NAN;
         if (simple) return baseFrequency;
 
-        if (lastUpdateTime + parameter->interval < time) {
-            std::uniform_real_distribution urd(-0.5, 0.5);
-            lastRange = urd(randomInstance) * parameter->range;
-            lastUpdateTime = time;
-        }
-        return baseFrequency + lastRange;
+        return baseFrequency + offsetAt(randomStream, updateIndex()) * parameter->range;
     }
 
     void RandomFrequency::resetTime(double time)
     {
         this->time = time;
-        lastUpdateTime = time;
+        epoch = time;
     }
 
     PeriodicFrequency::PeriodicFrequency() = default;
@@ -94,7 +104,7 @@ namespace VvvfSimulator::Vvvf::Modulation {
 
     void PeriodicFrequency::setCustomParameter(const decltype(parameter) &param, const decltype(baseWaveType) baseWaveType)
     {
-        this->parameter = parameter;
+        this->parameter = param;
         this->baseWaveType = baseWaveType;
     }
 
@@ -193,21 +203,11 @@ namespace VvvfSimulator::Vvvf::Modulation {
         auto &baseCarrierFreqParameter = electricalState.carrierFrequency->baseFrequency;
         double baseCarrierFrequency = 0.0;
 
-        if (auto constant = std::get_if<std::shared_ptr<
-            Model::ElectricalParameter::CarrierParameter::ConstantFrequency>>(&baseCarrierFreqParameter)) {
-            if (constant->get() == nullptr) {
-                static constexpr std::string_view exWhat = Q_FUNC_INFO
-                    + ": electricalState: Model::ElectricalParameter::carrierFrequency->baseFrequency is null.";
-                throw std::invalid_argument(exWhat);
-            }
-            baseCarrierFrequency = *(constant->get());
-        } else if (auto periodic = std::get_if<std::shared_ptr<
-            Model::ElectricalParameter::CarrierParameter::PeriodicFrequency>>(&baseCarrierFreqParameter)) {
-            if (periodic->get() == nullptr) {
-                static constexpr std::string_view exWhat = Q_FUNC_INFO
-                    + ": electricalState: Model::ElectricalParameter::carrierFrequency->baseFrequency is null.";
-                throw std::invalid_argument(exWhat);
-            }
+        if (auto constant = std::get_if<
+            Model::ElectricalParameter::CarrierParameter::ConstantFrequency>(&baseCarrierFreqParameter)) {
+            baseCarrierFrequency = *constant;
+        } else if (auto periodic = std::get_if<
+            Model::ElectricalParameter::CarrierParameter::PeriodicFrequency>(&baseCarrierFreqParameter)) {
             if (!electricalState.pulsePattern) {
                 static constexpr std::string_view exWhat = Q_FUNC_INFO
                     + ": electricalState: Model::ElectricalParameter::pulsePattern is null.";
@@ -7,6 +7,7 @@
 
 // Standard Library
 #include <memory>
+#include <optional>
 // Packages
 #include <QPointF>
 // Internal
@@ -38,17 +39,20 @@ namespace VvvfSimulator::Vvvf::Modulation {
         virtual void resetTime(double time) = 0;
     };
 
+    // The offset used during update interval n (counted from the last
+    // resetTime()) is drawn from element n of a counter-based stream keyed by
+    // the seed, so it only depends on (seed, time) and not on which samples
+    // were evaluated before: any time range renders the same in isolation.
     class RandomFrequency : public IFrequency {
         using ParameterT = Model::ElectricalParameter::CarrierParameter::RandomFrequency;
 
         double time = 0.0;
-        std::shared_ptr<ParameterT> parameter;
+        std::optional<ParameterT> parameter;
         bool simple = false;
         double baseFrequency = 0.0;
 
-        double lastRange = 0.0;
-        double lastUpdateTime = 0.0;
-        Random::xoshiro256ss randomInstance;
+        double epoch = 0.0;
+        Random::CounterStream randomStream;
 
     public:
         RandomFrequency(int64_t seed = 0);
@@ -59,6 +63,11 @@ namespace VvvfSimulator::Vvvf::Modulation {
         void setCustomParameter(const decltype(parameter) &param, double baseFrequency);
         double calculate() override;
         void resetTime(double time) override;
+
+        // Index of the update interval containing the current time
+        uint64_t updateIndex() const noexcept;
+        // Offset, relative to the range, in [-0.5, 0.5); 0 for the first interval
+        static double offsetAt(const Random::CounterStream &stream, uint64_t index) noexcept;
     };
 
     class PeriodicFrequency : public IFrequency {
@@ -68,7 +77,7 @@ namespace VvvfSimulator::Vvvf::Modulation {
         bool simple = false;
         double time = 0.0;
 
-        std::shared_ptr<ParameterT> parameter;
+        std::optional<ParameterT> parameter;
         std::optional<BaseWaveT> baseWaveType;
         double baseFrequency = 0.0;
 
@@ -0,0 +1,47 @@
+// Copyright © 2025 VvvfGeeks, VVVF Systems
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-or-later
+//
+// Vvvf/SIMD/PwmSimd.cpp
+
+#include "PwmSimd.hpp"
+
+namespace NAMESPACE_VVVF::Calculate
+{
+	namespace SIMD
+	{
+		SIMD_INSTANTIATE_FOR_LISTS(threePhaseCompareDetail, Util::SIMD::DefaultArchList, std::tuple<float, double>);
+
+		namespace
+		{
+			struct threePhaseCompareDispatcher
+			{
+				template <typename Arch>
+				void operator()(
+					Arch,
+					const ThreePhaseCompareParameter &param,
+					std::span<const double> time,
+					std::span<int_fast8_t> u,
+					std::span<int_fast8_t> v,
+					std::span<int_fast8_t> w
+				) const
+				{
+					threePhaseCompareDetail<double, Arch>{}(param, time, u, v, w);
+				}
+			};
+		}
+
+		void threePhaseCompare(
+			const ThreePhaseCompareParameter &param,
+			std::span<const double> time,
+			std::span<int_fast8_t> u,
+			std::span<int_fast8_t> v,
+			std::span<int_fast8_t> w
+		)
+		{
+			// Resolved once, on first use, from the instruction sets available at
+			// run time.
+			static const auto dispatched = xsimd::dispatch<Util::SIMD::DefaultArchList>(threePhaseCompareDispatcher{});
+			dispatched(param, time, u, v, w);
+		}
+	}
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+// Copyright © 2025 VvvfGeeks, VVVF Systems
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-or-later
+//
+// Vvvf/SIMD/PwmSimd.hpp
+
+#include "../InternalMath.hpp"
+
+// Standard Library
+#include <algorithm>
+#include <cinttypes>
+#include <span>
+// Packages
+#include <xsimd.hpp>
+// Internal
+#include "../Namespace_VVVF.h"
+#include "../../Util/Defines.h"
+#include "../../Util/SIMD.hpp"
+
+namespace NAMESPACE_VVVF::Calculate
+{
+	namespace SIMD
+	{
+		/// Constant parameters of a two-level, asynchronous sine/triangle
+		/// modulator, shared by the three phases over a whole block.
+		struct ThreePhaseCompareParameter
+		{
+			double sineAngleFrequency;    // rad/s
+			double carrierAngleFrequency; // rad/s
+			double amplitude;
+			double initialPhase;          // rad, added to every phase
+		};
+
+		//
+		// threePhaseCompare
+		//
+		// Evaluates base wave (amplitude-scaled sine, clamped to [-1, 1]), carrier
+		// (InternalMath::Functions::triangle) and their comparison for every time
+		// stamp, for U, V and W (spaced by 2pi/3). The carrier is evaluated once
+		// per time stamp and shared by the three phases. Each output span must be
+		// at least as long as the time span.
+		//
+		template <typename T, typename Arch = xsimd::default_arch>
+		struct threePhaseCompareDetail
+		{
+			void operator()(
+				const ThreePhaseCompareParameter &param,
+				std::span<const T> time,
+				std::span<int_fast8_t> u,
+				std::span<int_fast8_t> v,
+				std::span<int_fast8_t> w
+			) const;
+		};
+
+		template <typename T, typename Arch>
+		void threePhaseCompareDetail<T, Arch>::operator()(
+			const ThreePhaseCompareParameter &param,
+			std::span<const T> time,
+			std::span<int_fast8_t> u,
+			std::span<int_fast8_t> v,
+			std::span<int_fast8_t> w
+		) const
+		{
+			using namespace xsimd;
+			using BType = batch<T, Arch>;
+			using namespace InternalMath;
+
+			const std::span<int_fast8_t> out[3] = { u, v, w };
+			const T phaseOffset[3] = {
+				T(param.initialPhase),
+				T(param.initialPhase + m_2PI_3),
+				T(param.initialPhase + m_4PI_3)
+			};
+
+			const BType sineFreq(T(param.sineAngleFrequency)), carrierFreq(T(param.carrierAngleFrequency)),
+				amplitude(T(param.amplitude)), one(T(1)), two(T(2)), three(T(3)), four(T(4)), lower(T(-1)),
+				twoOverPi(T(m_2_PI)), oneOver2Pi(T(m_1_2PI));
+
+			const size_t n = time.size() - (time.size() % BType::size);
+			size_t i;
+			for (i = 0; i < n; i += BType::size)
+			{
+				const auto tb = BType::load_unaligned(&(time[i])); // tb: time batch
+
+				// Functions::triangle, branch-free
+				const auto cx = carrierFreq * tb;
+				const auto phase = twoOverPi * cx - four * floor(cx * oneOver2Pi);
+				const auto carrier = select(phase < one, phase, select(phase < three, two - phase, phase - four));
+
+				const auto sx = sineFreq * tb;
+				for (int p = 0; p < 3; p++)
+				{
+					const auto base = clip(amplitude * sin(sx + BType(phaseOffset[p])), lower, one);
+					const uint64_t mask = (base > carrier).mask();
+					for (size_t j = 0; j < BType::size; j++)
+						out[p][i + j] = static_cast<int_fast8_t>((mask >> j) & 1u);
+				}
+			}
+
+			using namespace std;
+			for (; i < time.size(); i++)
+			{
+				const T carrier = Functions::triangle(param.carrierAngleFrequency * time[i]);
+				const T sx = param.sineAngleFrequency * time[i];
+				for (int p = 0; p < 3; p++)
+				{
+					const T base = clamp(T(param.amplitude * sin(sx + phaseOffset[p])), T(-1), T(1));
+					out[p][i] = base > carrier ? 1 : 0;
+				}
+			}
+		}
+
+		SIMD_EXTERN_FOR_LISTS(threePhaseCompareDetail, Util::SIMD::DefaultArchList, std::tuple<float, double>);
+
+		/// Runtime-dispatched entry point: picks the best instantiation of
+		/// threePhaseCompareDetail<double, Arch> the running CPU supports (e.g.
+		/// SSE2, AVX2 or AVX-512 on x86-64).
+		void threePhaseCompare(
+			const ThreePhaseCompareParameter &param,
+			std::span<const double> time,
+			std::span<int_fast8_t> u,
+			std::span<int_fast8_t> v,
+			std::span<int_fast8_t> w
+		);
+	}
+}
@@ -0,0 +1,49 @@
+// Copyright © 2025 VvvfGeeks, VVVF Systems
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-or-later
+//
+// Vvvf/SIMD/TrajectorySimd.cpp
+
+#include "TrajectorySimd.hpp"
+
+namespace NAMESPACE_VVVF::InternalMath::Functions
+{
+	namespace SIMD
+	{
+		SIMD_INSTANTIATE_FOR_LISTS(clarkeTrajectoryDetail, Util::SIMD::DefaultArchList, std::tuple<float, double>);
+
+		namespace
+		{
+			struct clarkeTrajectoryDispatcher
+			{
+				template <typename Arch>
+				TrajectoryBounds operator()(
+					Arch,
+					std::span<const double> u,
+					std::span<const double> v,
+					std::span<const double> w,
+					std::span<const double> weight,
+					double scale,
+					std::span<double> alpha,
+					std::span<double> beta
+				) const
+				{
+					return clarkeTrajectoryDetail<double, Arch>{}(u, v, w, weight, scale, alpha, beta);
+				}
+			};
+		}
+
+		TrajectoryBounds clarkeTrajectory(
+			std::span<const double> u,
+			std::span<const double> v,
+			std::span<const double> w,
+			std::span<const double> weight,
+			double scale,
+			std::span<double> alpha,
+			std::span<double> beta
+		)
+		{
+			static const auto dispatched = xsimd::dispatch<Util::SIMD::DefaultArchList>(clarkeTrajectoryDispatcher{});
+			return dispatched(u, v, w, weight, scale, alpha, beta);
+		}
+	}
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+// Copyright © 2025 VvvfGeeks, VVVF Systems
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-or-later
+//
+// Vvvf/SIMD/TrajectorySimd.hpp
+
+#include "../InternalMath.hpp"
+
+// Standard Library
+#include <algorithm>
+#include <cstddef>
+#include <span>
+// Packages
+#include <xsimd.hpp>
+// Internal
+#include "../Namespace_VVVF.h"
+#include "../../Util/Defines.h"
+#include "../../Util/SIMD.hpp"
+
+namespace NAMESPACE_VVVF::InternalMath::Functions
+{
+	namespace SIMD
+	{
+		/// Extent of a trajectory, origin included.
+		struct TrajectoryBounds
+		{
+			double minAlpha = 0.0, minBeta = 0.0;
+			double maxAlpha = 0.0, maxBeta = 0.0;
+		};
+
+		namespace Detail
+		{
+			// Inclusive prefix sum inside one batch, in log2(size) shift-and-add steps
+			template <typename BType, std::size_t Shift = 1>
+			inline BType inclusiveScan(BType b)
+			{
+				if constexpr (Shift < BType::size)
+				{
+					b += xsimd::slide_left<Shift * sizeof(typename BType::value_type)>(b);
+					return inclusiveScan<BType, Shift * 2>(b);
+				}
+				else
+					return b;
+			}
+		}
+
+		//
+		// clarkeTrajectory
+		//
+		// Walks the voltage vector of a run-length coded three-phase PWM: the
+		// Clarke transform of every (u, v, w) state, alpha = (2u - v - w) / 3 and
+		// beta = (v - w) / sqrt(3), times scale and its run's weight, prefix-summed
+		// into alpha[i] and beta[i], the position at the end of run i. The extent
+		// is taken in the same pass. Each output span must be at least as long as
+		// the inputs.
+		//
+		template <typename T, typename Arch = xsimd::default_arch>
+		struct clarkeTrajectoryDetail
+		{
+			TrajectoryBounds operator()(
+				std::span<const T> u,
+				std::span<const T> v,
+				std::span<const T> w,
+				std::span<const T> weight,
+				T scale,
+				std::span<T> alpha,
+				std::span<T> beta
+			) const;
+		};
+
+		template <typename T, typename Arch>
+		TrajectoryBounds clarkeTrajectoryDetail<T, Arch>::operator()(
+			std::span<const T> u,
+			std::span<const T> v,
+			std::span<const T> w,
+			std::span<const T> weight,
+			T scale,
+			std::span<T> alpha,
+			std::span<T> beta
+		) const
+		{
+			using namespace xsimd;
+			using BType = batch<T, Arch>;
+
+			const T alphaScale = scale / T(3), betaScale = scale / T(m_SQRT3);
+			const BType alphaFactor(alphaScale), betaFactor(betaScale), two(T(2));
+
+			// Running sums are carried between batches as broadcasts of the last lane
+			BType alphaCarry(T(0)), betaCarry(T(0));
+			BType alphaMin(T(0)), alphaMax(T(0)), betaMin(T(0)), betaMax(T(0));
+
+			const size_t count = u.size();
+			const size_t n = count - (count % BType::size);
+			size_t i;
+			for (i = 0; i < n; i += BType::size)
+			{
+				const auto ub = BType::load_unaligned(&(u[i]));
+				const auto vb = BType::load_unaligned(&(v[i]));
+				const auto wb = BType::load_unaligned(&(w[i]));
+				const auto weightb = BType::load_unaligned(&(weight[i]));
+
+				const auto alphab = Detail::inclusiveScan(alphaFactor * weightb * (two * ub - vb - wb)) + alphaCarry;
+				const auto betab = Detail::inclusiveScan(betaFactor * weightb * (vb - wb)) + betaCarry;
+				alphab.store_unaligned(&(alpha[i]));
+				betab.store_unaligned(&(beta[i]));
+
+				alphaMin = min(alphaMin, alphab);
+				alphaMax = max(alphaMax, alphab);
+				betaMin = min(betaMin, betab);
+				betaMax = max(betaMax, betab);
+				alphaCarry = BType(alphab.get(BType::size - 1));
+				betaCarry = BType(betab.get(BType::size - 1));
+			}
+
+			TrajectoryBounds bounds{ reduce_min(alphaMin), reduce_min(betaMin), reduce_max(alphaMax), reduce_max(betaMax) };
+
+			T alphaSum = alphaCarry.get(0), betaSum = betaCarry.get(0);
+			for (; i < count; i++)
+			{
+				alphaSum += alphaScale * weight[i] * (T(2) * u[i] - v[i] - w[i]);
+				betaSum += betaScale * weight[i] * (v[i] - w[i]);
+				alpha[i] = alphaSum;
+				beta[i] = betaSum;
+				bounds.minAlpha = std::min<double>(bounds.minAlpha, alphaSum);
+				bounds.maxAlpha = std::max<double>(bounds.maxAlpha, alphaSum);
+				bounds.minBeta = std::min<double>(bounds.minBeta, betaSum);
+				bounds.maxBeta = std::max<double>(bounds.maxBeta, betaSum);
+			}
+			return bounds;
+		}
+
+		SIMD_EXTERN_FOR_LISTS(clarkeTrajectoryDetail, Util::SIMD::DefaultArchList, std::tuple<float, double>);
+
+		/// Runtime-dispatched entry point, see Calculate::SIMD::threePhaseCompare().
+		TrajectoryBounds clarkeTrajectory(
+			std::span<const double> u,
+			std::span<const double> v,
+			std::span<const double> w,
+			std::span<const double> weight,
+			double scale,
+			std::span<double> alpha,
+			std::span<double> beta
+		);
+	}
+}
@@ -1,179 +1,278 @@
 #include "YamlVvvfUtil.hpp"
 
 // Standard Library
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <exception>
 #include <functional>
+#include <vector>
 // Packages
-#include <QMessageBox>
-#include <QThreadPool>
-#include <QVector>
+#include <QtConcurrent/QtConcurrent>
+#include <QtDebug>
 // Internal
 #include "../../Generation/GenerateBasic.hpp"
 #include "../../Vvvf/Struct.hpp"
 
 namespace NAMESPACE_YAMLVVVFSOUND::YamlVvvfUtil::AutoModulationIndexSolver
 {
-	bool SolveConfiguration::run()
+	namespace
 	{
-		if (soundData.AcceleratePattern.size() == 0 || soundData.BrakingPattern.size() == 0) return false;
+		using YamlControlData = YamlVvvfSoundData::YamlControlData;
+		using AmplitudeParameter = YamlControlData::YamlAmplitude::AmplitudeParameter;
+		using AmplitudeTableEntry = AmplitudeParameter::AmplitudeTableEntry;
 
-		auto &accel = soundData.AcceleratePattern;
-		auto &brake = soundData.BrakingPattern;
+		/// <summary>
+		/// Table points one task solves in a row. Fixed rather than derived from
+		/// the pool size, as the warm starts make the results depend on it.
+		/// </summary>
+		constexpr size_t ChunkPoints = 16;
 
-		for (const auto &controlData : accel)
-			if (controlData.ControlFrequencyFrom < 0.0) return false;
+		/// <summary>
+		/// A Table mode entry being solved; table is filled in place and only
+		/// moved into the sound data once every chunk is done.
+		/// </summary>
+		struct EntryTarget
+		{
+			bool isBrakePattern;
+			size_t index;
+			double maxFrequency;
+			double maxVoltageRate;
+			std::vector<AmplitudeTableEntry> table;
+		};
 
-		for (const auto &controlData : brake)
-			if (controlData.ControlFrequencyFrom < 0.0) return false;
-		
-		soundData.sortAcceleratePattern(true);
-		soundData.sortBrakingPattern(true);
+		struct SolveChunk
+		{
+			EntryTarget *target;
+			size_t begin;
+			size_t end;
+		};
 
-		QThreadPool taskList;
+		std::vector<YamlControlData> &getPattern(YamlVvvfSoundData &soundData, bool isBrakePattern)
+		{
+			return isBrakePattern ? soundData.BrakingPattern : soundData.AcceleratePattern;
+		}
 
-		const auto solveModulationIndex = [](
-			const double targetFrequency,
-			InternalFunctionParameter &param,
-			const std::function<void(double)> &testAmplitudeSetter,
-			const std::function<void(double)> &amplitudeSetter
-		)
+		const std::vector<YamlControlData> &getPattern(const YamlVvvfSoundData &soundData, bool isBrakePattern)
 		{
-			try
-			{
-				double desireVoltageRate = std::min(targetFrequency / param.maxFrequency * param.maxVoltageRate, 1.0);
+			return isBrakePattern ? soundData.BrakingPattern : soundData.AcceleratePattern;
+		}
 
-				NAMESPACE_VVVF::Struct::VvvfValues control;
-				control.sinAngleFreq = targetFrequency * NAMESPACE_VVVF::InternalMath::m_2PI;
-				control.controlFrequency = targetFrequency;
-				control.masconOff = false;
-				control.freeRun = false;
-				control.brake = param.isBrakePattern;
-				control.allowRandomFreqMove = false;
+		/// <summary>
+		/// Spans the amplitude parameters of entry index from its own start
+		/// frequency to just below the next entry's, without range limits.
+		/// </summary>
+		void prepareEntry(std::vector<YamlControlData> &pattern, size_t index, double maxFrequency)
+		{
+			auto &parameter = pattern.at(index).Amplitude.Default;
+			auto &parameterPowerOn = pattern.at(index).Amplitude.PowerOn;
+			auto &parameterPowerOff = pattern.at(index).Amplitude.PowerOff;
 
-				const auto solveFunction = [&](double amplitude)
-				{
-					testAmplitudeSetter(amplitude);
-					const double difference = VvvfSimulator::Generation::GenerateBasic::Fourier::getVoltageRate(control, param.configuration.soundData, true, false) - desireVoltageRate;
-					return difference * 100.0;
-				};
-				double properAmplitude;
-				switch (param.configuration.solverType)
-				{
-				case EquationSolverType::Bissection:
-					properAmplitude = NAMESPACE_VVVF::InternalMath::EquationSolver::BisectionMethod(solveFunction).calculate(-10.0, 10.0, param.configuration.precision, param.configuration.maxEffort);
-					break;
-				case EquationSolverType::Newton:
-					properAmplitude = NAMESPACE_VVVF::InternalMath::EquationSolver::NewtonMethod(solveFunction, 0.05).calculate(desireVoltageRate, param.configuration.precision, param.configuration.maxEffort);
-					break;
-				default: properAmplitude = 0.0;
-				}
-				amplitudeSetter(properAmplitude);
-			}
-			catch (const std::exception &ex)
+			for (AmplitudeParameter *each : { &parameter, &parameterPowerOn, &parameterPowerOff })
 			{
-				// Put code here later!
-			};
-		};
-
-		const auto autoModulationIndexTask = [&](QThreadPool &taskList, InternalFunctionParameter &functionParameter)
-		{
-			auto &ysd = functionParameter.isBrakePattern ?
-				functionParameter.configuration.soundData.BrakingPattern :
-				functionParameter.configuration.soundData.AcceleratePattern;
-			auto &parameter = ysd.at(functionParameter.index).Amplitude.Default;
-			auto &parameterPowerOn = ysd.at(functionParameter.index).Amplitude.PowerOn;
-			auto &parameterPowerOff = ysd.at(functionParameter.index).Amplitude.PowerOff;
-
-			parameter.DisableRangeLimit = false;
-			parameter.MaxAmplitude = -1.0;
-			parameter.CutOffAmplitude = 0.0;
-			parameterPowerOn.DisableRangeLimit = false;
-			parameterPowerOn.MaxAmplitude = -1.0;
-			parameterPowerOn.CutOffAmplitude = 0.0;
-			parameterPowerOff.DisableRangeLimit = false;
-			parameterPowerOff.MaxAmplitude = -1.0;
-			parameterPowerOff.CutOffAmplitude = 0.0;
+				each->DisableRangeLimit = false;
+				each->MaxAmplitude = -1.0;
+				each->CutOffAmplitude = 0.0;
+			}
 			parameter.StartFrequency =
-				ysd.at(functionParameter.index).ControlFrequencyFrom <= 0.0 ?
+				pattern.at(index).ControlFrequencyFrom <= 0.0 ?
 				0.01 :
-				ysd.at(functionParameter.index).ControlFrequencyFrom;
+				pattern.at(index).ControlFrequencyFrom;
 			parameterPowerOn.StartFrequency = parameter.StartFrequency;
 			parameterPowerOff.StartFrequency = parameter.StartFrequency;
-			parameter.EndFrequency = functionParameter.index + 1 >= ysd.size() ?
-				functionParameter.maxFrequency + (ysd.at(functionParameter.index).ControlFrequencyFrom == functionParameter.maxFrequency ? 0.1 : 0) :
-				ysd.at(functionParameter.index + 1).ControlFrequencyFrom - 0.1;
+			parameter.EndFrequency = index + 1 >= pattern.size() ?
+				maxFrequency + (pattern.at(index).ControlFrequencyFrom == maxFrequency ? 0.1 : 0) :
+				pattern.at(index + 1).ControlFrequencyFrom - 0.1;
 			parameterPowerOn.EndFrequency = parameter.EndFrequency;
 			parameterPowerOff.EndFrequency = parameter.EndFrequency;
+		}
 
-			if(parameter.Mode == YamlVvvfSoundData::YamlControlData::YamlAmplitude::AmplitudeParameter::AmplitudeMode::Table)
+		std::vector<AmplitudeTableEntry> makeTable(const AmplitudeParameter &parameter, const SolveConfiguration &configuration)
+		{
+			std::vector<AmplitudeTableEntry> table;
+			if (configuration.isTableDivisionPerHz)
 			{
-				std::vector<YamlVvvfSoundData::YamlControlData::YamlAmplitude::AmplitudeParameter::AmplitudeTableEntry> modulationIndexList;
-				parameter.StartAmplitude = 0.0;
-				if (functionParameter.configuration.isTableDivisionPerHz)
-				{
-					for (double _Freq = parameter.StartFrequency; _Freq <= parameter.EndFrequency; _Freq += 1.0 / functionParameter.configuration.tableDivision)
-					{
-						modulationIndexList.push_back({_Freq, 0.0});
-					}
-					modulationIndexList.push_back({parameter.EndFrequency, 0.0});
-				}
-				else
-					for (int i = 0; i <= functionParameter.configuration.tableDivision; i++)
-						modulationIndexList.push_back({(parameter.EndFrequency - parameter.StartFrequency) / functionParameter.configuration.tableDivision * i + parameter.StartFrequency, 0.0});
-				
-				for (size_t index = 0; index < modulationIndexList.size(); index++)
-				{
-					double &frequency = modulationIndexList.at(index).Frequency;
-					parameter.AmplitudeTable = modulationIndexList;
-					auto tester = functionParameter; // Clone
-					taskList.start([&]()
-					{
-						solveModulationIndex(frequency, tester, [&](double amplitude)
-						{
-						YamlVvvfSoundData::YamlControlData &target =
-							(tester.isBrakePattern ?
-							tester.configuration.soundData.BrakingPattern :
-							tester.configuration.soundData.AcceleratePattern).at(tester.index);
-							target.Amplitude.Default.AmplitudeTable = { {frequency, amplitude} };
-						},
-						[&](double amplitude)
-						{
-							modulationIndexList.at(index) = {frequency, amplitude};
-							parameter.AmplitudeTable = modulationIndexList;
-						});
-					});
-				}
+				for (double _Freq = parameter.StartFrequency; _Freq <= parameter.EndFrequency; _Freq += 1.0 / configuration.tableDivision)
+					table.push_back({ _Freq, 0.0 });
+				table.push_back({ parameter.EndFrequency, 0.0 });
 			}
+			else
+				for (int i = 0; i <= configuration.tableDivision; i++)
+					table.push_back({ (parameter.EndFrequency - parameter.StartFrequency) / configuration.tableDivision * i + parameter.StartFrequency, 0.0 });
+			return table;
+		}
+
+		/// <summary>
+		/// The sound data getVoltageRate() sees while a pool thread solves: a
+		/// copy of the shared data in which the entry being solved holds a
+		/// single-point table with the trial amplitude. Made once per thread and
+		/// run, as the trial has to reach calculateYaml() through the sound data.
+		/// </summary>
+		struct Probe
+		{
+			uint64_t run = 0;
+			YamlVvvfSoundData soundData;
+			const EntryTarget *target = nullptr;
 		};
-		for (size_t i = 0; i < accel.size(); i++)
+
+		std::atomic<uint64_t> solveRun{0};
+		thread_local Probe threadProbe;
+
+		/// <summary>
+		/// The probe of the calling thread, set up for target; the entry of the
+		/// previous target gets its shared table back.
+		/// </summary>
+		AmplitudeTableEntry &getTrial(const EntryTarget &target, const YamlVvvfSoundData &soundData, uint64_t run)
 		{
-			InternalFunctionParameter param
+			Probe &probe = threadProbe;
+			if (probe.run != run)
 			{
-				*this,
-				false,
-				i,
-				accelEndFrequency,
-				accelMaxVoltage / 100.0
+				probe.soundData = soundData;
+				probe.run = run;
+				probe.target = nullptr;
+			}
+			const auto tableOf = [](auto &data, const EntryTarget &entry) -> auto &
+			{
+				return getPattern(data, entry.isBrakePattern).at(entry.index).Amplitude.Default.AmplitudeTable;
 			};
-			autoModulationIndexTask(taskList, param);
+			if (probe.target != &target)
+			{
+				if (probe.target) tableOf(probe.soundData, *probe.target) = tableOf(soundData, *probe.target);
+				tableOf(probe.soundData, target).assign(1, {});
+				probe.target = &target;
+			}
+			return tableOf(probe.soundData, target).front();
 		}
-		for (size_t i = 0; i < brake.size(); i++)
+
+		/// <summary>
+		/// Solves the points of one chunk in order. The shared sound data is
+		/// only read: the trial amplitudes go into the thread's probe (see
+		/// getTrial()).
+		/// </summary>
+		void solveChunk(const SolveChunk &chunk, const SolveConfiguration &configuration, uint64_t run)
 		{
-			InternalFunctionParameter param
+			using namespace NAMESPACE_VVVF::InternalMath::EquationSolver;
+
+			EntryTarget &target = *chunk.target;
+			AmplitudeTableEntry &trial = getTrial(target, configuration.soundData, run);
+			const YamlVvvfSoundData &probe = threadProbe.soundData;
+
+			NAMESPACE_VVVF::Struct::VvvfValues control;
+			control.masconOff = false;
+			control.freeRun = false;
+			control.brake = target.isBrakePattern;
+			control.allowRandomFreqMove = false;
+
+			VvvfSimulator::Generation::GenerateBasic::WaveForm::EdgeList scratch;
+			double desireVoltageRate = 0.0;
+			const Function solveFunction = [&](double amplitude)
 			{
-				*this,
-				true,
-				i,
-				accelEndFrequency,
-				accelMaxVoltage / 100.0
+				trial.Amplitude = amplitude;
+				const double difference = VvvfSimulator::Generation::GenerateBasic::Fourier::getVoltageRate(control, probe, true, false, scratch) - desireVoltageRate;
+				return difference * 100.0;
 			};
-			autoModulationIndexTask(taskList, param);
+			NewtonMethod newton(solveFunction, 0.05);
+			BisectionMethod bisection(solveFunction);
+
+			bool warm = false;
+			double previous = 0.0;
+			for (size_t i = chunk.begin; i < chunk.end; i++)
+			{
+				AmplitudeTableEntry &entry = target.table.at(i);
+				const double targetFrequency = entry.Frequency;
+				desireVoltageRate = std::min(targetFrequency / target.maxFrequency * target.maxVoltageRate, 1.0);
+				control.sinAngleFreq = targetFrequency * NAMESPACE_VVVF::InternalMath::m_2PI;
+				control.controlFrequency = targetFrequency;
+				trial.Frequency = targetFrequency;
+
+				try
+				{
+					double properAmplitude;
+					switch (configuration.solverType)
+					{
+					case EquationSolverType::Bissection:
+					{
+						// A narrow bracket around the neighbour's solution when it holds the root
+						double lower = -10.0, upper = 10.0;
+						if (warm)
+						{
+							const double margin = 0.05 + 0.1 * std::abs(previous);
+							if (solveFunction(previous - margin) * solveFunction(previous + margin) < 0.0)
+							{
+								lower = previous - margin;
+								upper = previous + margin;
+							}
+						}
+						properAmplitude = bisection(lower, upper, configuration.precision, configuration.maxEffort);
+						break;
+					}
+					case EquationSolverType::Newton:
+						properAmplitude = newton(warm ? previous : desireVoltageRate, configuration.precision, configuration.maxEffort);
+						break;
+					default: properAmplitude = 0.0;
+					}
+					entry.Amplitude = properAmplitude;
+					previous = properAmplitude;
+					warm = std::isfinite(properAmplitude);
+				}
+				catch (const std::exception &ex)
+				{
+					qWarning() << "Auto modulation index: no solution at" << targetFrequency << "Hz:" << ex.what();
+					entry.Amplitude = 0.0;
+					warm = false;
+				}
+			}
 		}
-		taskList.waitForDone();
+	}
+
+	bool SolveConfiguration::run()
+	{
+		if (soundData.AcceleratePattern.size() == 0 || soundData.BrakingPattern.size() == 0) return false;
+
+		auto &accel = soundData.AcceleratePattern;
+		auto &brake = soundData.BrakingPattern;
+
+		for (const auto &controlData : accel)
+			if (controlData.ControlFrequencyFrom < 0.0) return false;
+
+		for (const auto &controlData : brake)
+			if (controlData.ControlFrequencyFrom < 0.0) return false;
+		
+		soundData.sortAcceleratePattern(true);
+		soundData.sortBrakingPattern(true);
+
+		std::vector<EntryTarget> targets;
+		const auto addTargets = [&](bool isBrakePattern, double maxFrequency, double maxVoltage)
+		{
+			auto &pattern = getPattern(soundData, isBrakePattern);
+			for (size_t i = 0; i < pattern.size(); i++)
+			{
+				prepareEntry(pattern, i, maxFrequency);
+				auto &parameter = pattern.at(i).Amplitude.Default;
+				if (parameter.Mode != AmplitudeParameter::AmplitudeMode::Table) continue;
+				parameter.StartAmplitude = 0.0;
+				targets.push_back({ isBrakePattern, i, maxFrequency, maxVoltage / 100.0, makeTable(parameter, *this) });
+			}
+		};
+		addTargets(false, accelEndFrequency, accelMaxVoltage);
+		addTargets(true, brakeEndFrequency, brakeMaxVoltage);
+
+		// Every table is cut the same way regardless of the pool size
+		std::vector<SolveChunk> chunks;
+		for (EntryTarget &target : targets)
+			for (size_t begin = 0; begin < target.table.size(); begin += ChunkPoints)
+				chunks.push_back({ &target, begin, std::min(begin + ChunkPoints, target.table.size()) });
+
+		// soundData is read-only until every chunk is solved
+		const uint64_t run = ++solveRun;
+		QtConcurrent::blockingMap(chunks, [this, run](SolveChunk &chunk) { solveChunk(chunk, *this, run); });
+
+		for (EntryTarget &target : targets)
+			getPattern(soundData, target.isBrakePattern).at(target.index).Amplitude.Default.AmplitudeTable = std::move(target.table);
 
 		soundData.sortAcceleratePattern(false);
 		soundData.sortBrakingPattern(false);
 
 		return true;
 	}
-}
\ No newline at end of file
+}
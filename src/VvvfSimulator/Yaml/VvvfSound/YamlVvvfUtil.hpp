@@ -32,6 +32,13 @@ namespace NAMESPACE_YAMLVVVFSOUND::YamlVvvfUtil
 	{
 		using namespace NAMESPACE_VVVF::InternalMath::EquationSolver;
 
+		/// <summary>
+		/// Regenerates the amplitude tables of every Table mode entry so that the
+		/// voltage rate rises linearly to the given maximum at the given end
+		/// frequency. Table points are solved in fixed chunks on the global thread
+		/// pool, each point warm-starting from the previous one of its chunk, so
+		/// the tables do not depend on the number of threads.
+		/// </summary>
 		struct SolveConfiguration
 		{		
 			YamlVvvfSoundData soundData;
@@ -47,14 +54,5 @@ namespace NAMESPACE_YAMLVVVFSOUND::YamlVvvfUtil
 
 			bool run();
 		};
-
-		struct InternalFunctionParameter
-		{
-			SolveConfiguration configuration;
-			bool isBrakePattern;
-			int64_t index;
-			double maxFrequency;
-			double maxVoltageRate;
-		};
 	}
 }
\ No newline at end of file
@@ -39,6 +39,9 @@
 #include <QtSystemDetection>
 // Internal
 #include "VvvfSimulator/Exception.hpp"
+#ifdef VVVF_BATCH_RENDER
+#include "VvvfSimulator/Generation/BatchRenderEntry.hpp"
+#endif
 
 std::optional<std::filesystem::path> logPath = std::nullopt;
 QtMessageHandler originalHandler = nullptr;
@@ -103,6 +106,12 @@ int main(int argc, char *argv[])
 		*/
 
 	av::init();
+
+	#ifdef VVVF_BATCH_RENDER
+	// Headless batch render: no QML engine, no instance check, no windows
+	if (VvvfSimulator::Generation::BatchRender::isRequested(argc, argv))
+		return VvvfSimulator::Generation::BatchRender::exec(argc, argv);
+	#endif
 	
 	// Set up standard output to UTF-8
 	const auto originalCoutLocale = std::cout.getloc();